@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: Copyright 2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#ifdef DEMO_BG_BOX_BENCHMARK_ENABLED
+
+namespace bench
+{
+
+struct TilePlotResult
+{
+    // tiles plotted by each kernel
+    int tileCount;
+
+    // CPU cycles taken by each kernel, converted from the ticks of `bn::timer`
+    int perDotCycles;
+    int maskCycles;
+    int tableCycles;
+
+    // ROM used by the edge pattern tables of `demo::plotBoxTile()`
+    int tableRomSize;
+
+    // whether every kernel plotted the same dots
+    bool isSame;
+};
+
+/**
+ * @brief Plots the 16 border tiles of a `demo::BgBox` on every sub-tile offset,
+ * with `demo::plotTilePerDot()`, `demo::plotTile()` and `demo::plotBoxTile()`, measured with `bn::timer`.
+ *
+ * A tick of `bn::timer` is 64 CPU cycles, so the cycles are rounded to that.
+ */
+auto runTilePlot() -> TilePlotResult;
+
+} // namespace bench
+
+#endif // DEMO_BG_BOX_BENCHMARK_ENABLED
@@ -7,6 +7,7 @@
 #include <bn_bg_palette_ptr.h>
 #include <bn_colors.h>
 #include <bn_optional.h>
+#include <bn_point.h>
 #include <bn_regular_bg_map_item.h>
 #include <bn_regular_bg_map_ptr.h>
 #include <bn_regular_bg_ptr.h>
@@ -22,6 +23,7 @@ namespace demo
  * @brief Box drawn on top of a 4bpp `regular_bg` canvas.
  *
  * This owns a `bn::regular_bg_ptr` as a canvas, along with run-time tiles, map and palette.
+ * The tiles & map are allocated in VRAM, and only the parts changed are copied on `commit()`.
  */
 class BgBox
 {
@@ -40,6 +42,12 @@ public:
     auto getWidth() const -> bn::fixed;
     auto getHeight() const -> bn::fixed;
 
+    /**
+     * @brief Redraws the box in the cells & tiles, which are copied to VRAM by `commit()`.
+     *
+     * A move by scroll is shown on the next `bn::core::update()` right away,
+     * so `commit()` must be called every frame to keep the map in sync with the canvas position.
+     */
     void setRect(const bn::top_left_fixed_rect& boxRect);
     void setPosition(const bn::fixed_point& position);
     void setWidth(bn::fixed width);
@@ -47,29 +55,72 @@ public:
 
     int getBorderThickness() const;
 
+    /**
+     * @brief Whether a move without resizing only scrolls the canvas, without redrawing cells & tiles.
+     *
+     * The move is scrolled only if the box is inside the map both before & after,
+     * so the canvas position must not be changed from outside while it's enabled.
+     */
+    bool isMoveByScrollEnabled() const;
+    void setMoveByScrollEnabled(bool enabled);
+
     auto getCanvas() -> bn::regular_bg_ptr&;
     auto getCanvas() const -> const bn::regular_bg_ptr&;
 
+    /**
+     * @brief Copies the cell row spans & tiles changed since the last commit to VRAM.
+     *
+     * Call it right after `bn::core::update()`, so that the copy is done in VBlank.
+     */
+    BN_CODE_IWRAM void commit();
+
+private:
+    struct CellPos
+    {
+        int8_t x, y;
+    };
+
+    // inclusive cell range, which `xHi` or `yHi` might be less than the `Lo` if the fill is empty
+    struct CellRect
+    {
+        int8_t xLo, xHi, yLo, yHi;
+
+        bool operator==(const CellRect&) const = default;
+    };
+
+    struct CellBounds
+    {
+        CellRect border, fill;
+
+        bool operator==(const CellBounds&) const = default;
+    };
+
+    // inclusive cell range in a row, which is empty if `xLo > xHi`
+    struct CellSpan
+    {
+        int8_t xLo, xHi;
+    };
+
 private:
     BN_CODE_IWRAM void redraw();
 
     auto getClampedRect() const -> bn::top_left_fixed_rect;
 
+    static bool isInsideMap(const bn::top_left_fixed_rect& rawRect);
+
 private:
-    BN_CODE_IWRAM void setCell(int x, int y, int tileIdx);
-    BN_CODE_IWRAM void setCellLine(int xLo, int xHi, int y, int tileIdx);
-    BN_CODE_IWRAM void drawMapSides(bool isOuter, int xLo, int xHi, int yLo, int yHi);
+    BN_CODE_IWRAM void markCellsDirty(int xLo, int xHi, int y);
+    BN_CODE_IWRAM void clearCells(const CellRect& clip);
+    BN_CODE_IWRAM void drawMap(const CellBounds& bounds, const CellRect& clip);
+    BN_CODE_IWRAM void setCell(const CellRect& clip, int x, int y, int tileIdx);
+    BN_CODE_IWRAM void setCellLine(const CellRect& clip, int xLo, int xHi, int y, int tileIdx);
+    BN_CODE_IWRAM void drawMapSides(const CellRect& clip, bool isOuter, const CellRect& sides);
+    BN_CODE_IWRAM void updateUsedTilePos(const CellBounds& bounds);
 
 private:
     static auto convertToPositiveRect(const bn::top_left_fixed_rect& rawRect) -> bn::top_left_fixed_rect;
     static auto convertToPositiveIntRect(const bn::top_left_fixed_rect& rawRect) -> bn::top_left_rect;
 
-private:
-    struct CellPos
-    {
-        int8_t x, y;
-    };
-
     enum TileIdx
     {
         EMPTY = 0,
@@ -111,15 +162,36 @@ private:
     const uint8_t _borderColorIdx;
     const uint8_t _fillColorIdx;
 
+    bool _moveByScrollEnabled;
+
     bn::top_left_fixed_rect _rawRect;
 
+    // position of the canvas, which the box is moved by since it's drawn on the map last time
+    bn::point _scroll;
+
+    // same as the cells in VRAM, which refer to the tiles & palette by their allocated position
     alignas(4) bn::regular_bg_map_cell _cells[MAP_SIZE.width() * MAP_SIZE.height()];
+
+    // cell of each `TileIdx` as written to `_cells`, with the offsets of the tiles & palette
+    alignas(4) bn::regular_bg_map_cell _tileCells[UNIQUE_TILE_COUNT];
+
     alignas(4) bn::tile _tiles[UNIQUE_TILE_COUNT];
     alignas(4) bn::color _colors[16];
 
     // if unused, {x = -1, y = -1}
     alignas(4) CellPos _usedTilePos[UNIQUE_TILE_COUNT];
 
+    // edges of the rects relative to the used tile pos, when each tile is plotted last time
+    uint32_t _plotKeys[UNIQUE_TILE_COUNT];
+
+    // cells & tiles not committed to VRAM yet
+    alignas(4) CellSpan _dirtyCellSpans[MAP_SIZE.height()];
+    uint32_t _dirtyTiles;
+
+    // cells drawn on the map last time, to redraw only the cell rows & columns changed.
+    // if nothing is drawn yet, every field is -1
+    CellBounds _drawnBounds;
+
     bn::regular_bg_map_item _mapItem;
 
     bn::bg_palette_ptr _palette;
@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: Copyright 2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <cstdint>
+
+#include <bn_tile.h>
+#include <bn_top_left_rect.h>
+
+namespace demo
+{
+
+/// @brief ROM used by the edge pattern tables of `plotBoxTile()`.
+constexpr int EDGE_PATTERNS_ROM_SIZE = 2 * (2 * 8 + 1) * (8 + 1) * sizeof(uint32_t);
+
+/**
+ * @brief Plots a 4bpp tile at (`tileX`, `tileY`) pixels of a box,
+ * which fill is `borderRect` shrunk by `borderThickness`.
+ *
+ * The dots of each axis are looked up from the constexpr edge pattern tables,
+ * indexed by the side of the edge, its sub-tile offset and the thickness.
+ * Only 2 row words are remapped to the color indices, and each row is picked from them.
+ */
+BN_CODE_IWRAM void plotBoxTile(bn::tile& tile, int tileX, int tileY, const bn::top_left_rect& borderRect,
+                               int borderThickness, int fillColorIdx, int borderColorIdx);
+
+#ifdef DEMO_BG_BOX_BENCHMARK_ENABLED
+
+/**
+ * @brief Plots the dots of a 4bpp tile at (`tileX`, `tileY`) pixels, which are inside `fillRect` or `borderRect`.
+ *
+ * The fill & border spans of the tile are made into nibble masks once,
+ * so each row is made with a few word-wide mask ops, without per-dot branches.
+ * Only kept to be compared with in the benchmark, so it's built only with the benchmark.
+ */
+BN_CODE_IWRAM void plotTile(bn::tile& tile, int tileX, int tileY, const bn::top_left_rect& borderRect,
+                            const bn::top_left_rect& fillRect, int fillColorIdx, int borderColorIdx);
+
+/// @brief Same as `plotTile()`, but tests the rects per dot. Only kept to be compared with in the benchmark.
+BN_CODE_IWRAM void plotTilePerDot(bn::tile& tile, int tileX, int tileY, const bn::top_left_rect& borderRect,
+                                  const bn::top_left_rect& fillRect, int fillColorIdx, int borderColorIdx);
+
+#endif // DEMO_BG_BOX_BENCHMARK_ENABLED
+
+} // namespace demo
@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: Copyright 2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "Benchmarks.hpp"
+
+#include <cstdint>
+
+#include <bn_timer.h>
+#include <bn_vector.h>
+
+#include "TilePlot.hpp"
+
+#ifdef DEMO_BG_BOX_BENCHMARK_ENABLED
+
+namespace bench
+{
+
+namespace
+{
+
+constexpr int TILE_LEN = 8;
+constexpr int BORDER_THICKNESS = 2;
+constexpr int BORDER_TILE_COUNT = 16;
+constexpr int REPEAT_COUNT = 8;
+
+constexpr int CPU_CYCLES_PER_SECOND = 16 * 1024 * 1024;
+
+constexpr int FILL_COLOR_IDX = 2;
+constexpr int BORDER_COLOR_IDX = 1;
+
+struct BoxRects
+{
+    bn::top_left_rect borderRect, fillRect;
+};
+
+struct PlotArgs
+{
+    int tileX, tileY;
+    const BoxRects* box;
+};
+
+/// @brief Adds the 4 corners & 4 sides tiles of `rect`, like the used tile pos of `demo::BgBox`.
+void addSideTiles(const bn::top_left_rect& rect, const BoxRects& box, bn::ivector<PlotArgs>& plots)
+{
+    const int xLo = rect.left() / TILE_LEN;
+    const int xHi = (rect.right() - 1) / TILE_LEN;
+    const int yLo = rect.top() / TILE_LEN;
+    const int yHi = (rect.bottom() - 1) / TILE_LEN;
+
+    const int cellPositions[][2] = {
+        {xLo, yLo}, {xLo + 1, yLo}, {xHi, yLo}, {xLo, yLo + 1},
+        {xHi, yLo + 1}, {xLo, yHi}, {xLo + 1, yHi}, {xHi, yHi},
+    };
+
+    for (const auto& cellPos : cellPositions)
+        plots.push_back(PlotArgs{cellPos[0] * TILE_LEN, cellPos[1] * TILE_LEN, &box});
+}
+
+template <typename PlotFunc>
+auto runPlots(const bn::ivector<PlotArgs>& plots, PlotFunc plotFunc, uint32_t& checksum) -> int
+{
+    bn::tile tile;
+    checksum = 0;
+
+    bn::timer timer;
+
+    for (int repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+    {
+        for (const PlotArgs& plot : plots)
+        {
+            plotFunc(tile, plot.tileX, plot.tileY, plot.box->borderRect, plot.box->fillRect, FILL_COLOR_IDX,
+                     BORDER_COLOR_IDX);
+
+            // keep the plots from being optimized out
+            checksum = (checksum * 31) ^ tile.data[0] ^ tile.data[TILE_LEN - 1];
+        }
+    }
+
+    return timer.elapsed_ticks();
+}
+
+/// @brief A tick of `bn::timer` is 64 CPU cycles, so the cycles are rounded to that.
+auto ticksToCycles(int ticks) -> int
+{
+    return ticks * (CPU_CYCLES_PER_SECOND / bn::timers::ticks_per_second());
+}
+
+} // namespace
+
+auto runTilePlot() -> TilePlotResult
+{
+    bn::vector<BoxRects, TILE_LEN> boxes;
+    bn::vector<PlotArgs, BORDER_TILE_COUNT * TILE_LEN> plots;
+
+    // every sub-tile offset of the edges
+    for (int offset = 0; offset < TILE_LEN; ++offset)
+    {
+        const bn::top_left_rect borderRect(16 + offset, 16 + offset, 64, 48);
+        const bn::top_left_rect fillRect(borderRect.x() + BORDER_THICKNESS, borderRect.y() + BORDER_THICKNESS,
+                                         borderRect.width() - 2 * BORDER_THICKNESS,
+                                         borderRect.height() - 2 * BORDER_THICKNESS);
+
+        boxes.push_back(BoxRects{borderRect, fillRect});
+        const BoxRects& box = boxes.back();
+
+        addSideTiles(borderRect, box, plots);
+        addSideTiles(fillRect, box, plots);
+    }
+
+    TilePlotResult result;
+    result.tileCount = plots.size() * REPEAT_COUNT;
+
+    uint32_t perDotChecksum, maskChecksum;
+    result.perDotCycles = ticksToCycles(runPlots(plots, demo::plotTilePerDot, perDotChecksum));
+    result.maskCycles = ticksToCycles(runPlots(plots, demo::plotTile, maskChecksum));
+
+    const auto plotWithTables = [](bn::tile& tile, int tileX, int tileY, const bn::top_left_rect& borderRect,
+                                const bn::top_left_rect&, int fillColorIdx, int borderColorIdx) {
+        demo::plotBoxTile(tile, tileX, tileY, borderRect, BORDER_THICKNESS, fillColorIdx, borderColorIdx);
+    };
+
+    uint32_t tableChecksum;
+    result.tableCycles = ticksToCycles(runPlots(plots, plotWithTables, tableChecksum));
+    result.tableRomSize = demo::EDGE_PATTERNS_ROM_SIZE;
+
+    // compare every row, not only the checksum
+    result.isSame = (perDotChecksum == maskChecksum) && (perDotChecksum == tableChecksum);
+    for (const PlotArgs& plot : plots)
+    {
+        bn::tile perDotTile, maskTile, tableTile;
+        demo::plotTilePerDot(perDotTile, plot.tileX, plot.tileY, plot.box->borderRect, plot.box->fillRect,
+                             FILL_COLOR_IDX, BORDER_COLOR_IDX);
+        demo::plotTile(maskTile, plot.tileX, plot.tileY, plot.box->borderRect, plot.box->fillRect, FILL_COLOR_IDX,
+                       BORDER_COLOR_IDX);
+        plotWithTables(tableTile, plot.tileX, plot.tileY, plot.box->borderRect, plot.box->fillRect, FILL_COLOR_IDX,
+                       BORDER_COLOR_IDX);
+
+        for (int y = 0; y < TILE_LEN; ++y)
+            result.isSame = result.isSame && (perDotTile.data[y] == maskTile.data[y]) &&
+                            (perDotTile.data[y] == tableTile.data[y]);
+    }
+
+    return result;
+}
+
+} // namespace bench
+
+#endif // DEMO_BG_BOX_BENCHMARK_ENABLED
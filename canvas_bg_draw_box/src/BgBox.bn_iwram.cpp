@@ -5,7 +5,9 @@
 
 #include <bn_memory.h>
 #include <bn_profiler.h>
-#include <bn_regular_bg_map_cell_info.h>
+#include <bn_span.h>
+
+#include "TilePlot.hpp"
 
 #ifdef DEMO_BG_BOX_PROFILER_ENABLED
 
@@ -54,36 +56,40 @@ namespace demo
 namespace
 {
 
-BN_CODE_IWRAM inline uint8_t getPlotColor(int dotX, int dotY, const bn::top_left_rect& borderRect,
-                                          const bn::top_left_rect& fillRect, int fillColorIdx, int borderColorIdx)
+/// @brief Lowest & highest cells of the rects, as `hi` can be less than `lo` if the fill is empty.
+BN_CODE_IWRAM inline void expandSpan(int lo, int hi, int& spanLo, int& spanHi)
 {
-    const bn::point dotPos(dotX, dotY);
-
-    if ((fillRect.left() <= dotPos.x() && dotPos.x() < fillRect.right()) &&
-        (fillRect.top() <= dotPos.y() && dotPos.y() < fillRect.bottom()))
-        return fillColorIdx;
-    if ((borderRect.left() <= dotPos.x() && dotPos.x() < borderRect.right()) &&
-        (borderRect.top() <= dotPos.y() && dotPos.y() < borderRect.bottom()))
-        return borderColorIdx;
-    return 0;
+    spanLo = bn::min(spanLo, bn::min(lo, hi));
+    spanHi = bn::max(spanHi, bn::max(lo, hi));
 }
 
-} // namespace
+/// @brief Which sides of the border & fill a cell row (or column) `v` is on.
+/// Cells in the rows and columns of the same classes are drawn the same.
+BN_CODE_IWRAM inline int getLineClass(int v, int borderLo, int borderHi, int fillLo, int fillHi)
+{
+    return (v == borderLo) << 0 | (v == borderHi) << 1 | (borderLo < v && v < borderHi) << 2 | (v == fillLo) << 3 |
+           (v == fillHi) << 4 | (fillLo < v && v < fillHi) << 5;
+}
 
-BN_CODE_IWRAM void BgBox::redraw()
+/// @brief Edges of the rects relative to a tile, which decide the dots plotted on it.
+BN_CODE_IWRAM inline uint32_t getPlotKey(int tileX, int tileY, const bn::top_left_rect& borderRect,
+                                         const bn::top_left_rect& fillRect)
 {
-    DEMO_BG_BOX_PROFILER_START("map: clear");
-    // clear map
-    BN_ASSERT(sizeof(_cells) % 4 == 0);
-    bn::memory::set_words(0, sizeof(_cells) / 4, _cells);
-    DEMO_BG_BOX_PROFILER_STOP();
+    const int pX = tileX * 8;
+    const int pY = tileY * 8;
 
-    DEMO_BG_BOX_PROFILER_START("used tile pos: clear");
-    // clear `_usedTilePos`
-    BN_ASSERT(sizeof(_usedTilePos) % 4 == 0);
-    bn::memory::set_words(-1, sizeof(_usedTilePos) / 4, _usedTilePos);
-    DEMO_BG_BOX_PROFILER_STOP();
+    const auto edge = [](int value) -> uint32_t { return bn::clamp(value, 0, 8); };
+
+    return (edge(borderRect.left() - pX) << 0u) | (edge(borderRect.right() - pX) << 4u) |
+           (edge(borderRect.top() - pY) << 8u) | (edge(borderRect.bottom() - pY) << 12u) |
+           (edge(fillRect.left() - pX) << 16u) | (edge(fillRect.right() - pX) << 20u) |
+           (edge(fillRect.top() - pY) << 24u) | (edge(fillRect.bottom() - pY) << 28u);
+}
+
+} // namespace
 
+BN_CODE_IWRAM void BgBox::redraw()
+{
     DEMO_BG_BOX_PROFILER_START("map: get rects");
     const auto borderRect = convertToPositiveIntRect(getClampedRect());
     const auto fillRect = bn::top_left_rect{
@@ -92,31 +98,80 @@ BN_CODE_IWRAM void BgBox::redraw()
         bn::max(0, borderRect.width() - 2 * _borderThickness),
         bn::max(0, borderRect.height() - 2 * _borderThickness),
     };
+
+    const CellBounds bounds{
+        .border = {int8_t(borderRect.left() / TILE_LEN), int8_t((borderRect.right() - 1) / TILE_LEN),
+                   int8_t(borderRect.top() / TILE_LEN), int8_t((borderRect.bottom() - 1) / TILE_LEN)},
+        .fill = {int8_t(fillRect.left() / TILE_LEN), int8_t((fillRect.right() - 1) / TILE_LEN),
+                 int8_t(fillRect.top() / TILE_LEN), int8_t((fillRect.bottom() - 1) / TILE_LEN)},
+    };
     DEMO_BG_BOX_PROFILER_STOP();
 
-    DEMO_BG_BOX_PROFILER_START("map: draw");
-    // map: draw border
-    int xLo = borderRect.left() / TILE_LEN;
-    int yLo = borderRect.top() / TILE_LEN;
-    int xHi = (borderRect.right() - 1) / TILE_LEN;
-    int yHi = (borderRect.bottom() - 1) / TILE_LEN;
+    // The map is unchanged if the box moved or resized within the same cells, so only the tiles are plotted.
+    const bool mapChanged = (bounds != _drawnBounds);
 
-    // map: draw border sides
-    drawMapSides(true, xLo, xHi, yLo, yHi);
+    if (mapChanged)
+    {
+        const CellBounds& prev = _drawnBounds;
 
-    // map: draw fill
-    xLo = fillRect.left() / TILE_LEN;
-    yLo = fillRect.top() / TILE_LEN;
-    xHi = (fillRect.right() - 1) / TILE_LEN;
-    yHi = (fillRect.bottom() - 1) / TILE_LEN;
+        // cells out of these spans are empty both before & after
+        int xLo = MAP_SIZE.width(), xHi = -1, yLo = MAP_SIZE.height(), yHi = -1;
+        const CellRect* rects[] = {&prev.border, &prev.fill, &bounds.border, &bounds.fill};
+        for (const CellRect* rect : rects)
+        {
+            expandSpan(rect->xLo, rect->xHi, xLo, xHi);
+            expandSpan(rect->yLo, rect->yHi, yLo, yHi);
+        }
 
-    // map: draw fill sides
-    drawMapSides(false, xLo, xHi, yLo, yHi);
+        const CellRect span{
+            int8_t(bn::max(0, xLo)),
+            int8_t(bn::min(MAP_SIZE.width() - 1, xHi)),
+            int8_t(bn::max(0, yLo)),
+            int8_t(bn::min(MAP_SIZE.height() - 1, yHi)),
+        };
 
-    // map: draw fill mid
-    for (int y = yLo + 1; y <= yHi - 1; ++y)
-        setCellLine(xLo + 1, xHi - 1, y, TileIdx::MID_INNER);
-    DEMO_BG_BOX_PROFILER_STOP();
+        // rows & columns which class is changed, as bit flags
+        static_assert(MAP_SIZE.width() <= 32 && MAP_SIZE.height() <= 32);
+        uint32_t dirtyRows = 0;
+        uint32_t dirtyColumns = 0;
+
+        for (int y = span.yLo; y <= span.yHi; ++y)
+        {
+            if (getLineClass(y, prev.border.yLo, prev.border.yHi, prev.fill.yLo, prev.fill.yHi) !=
+                getLineClass(y, bounds.border.yLo, bounds.border.yHi, bounds.fill.yLo, bounds.fill.yHi))
+                dirtyRows |= 1u << y;
+        }
+        for (int x = span.xLo; x <= span.xHi; ++x)
+        {
+            if (getLineClass(x, prev.border.xLo, prev.border.xHi, prev.fill.xLo, prev.fill.xHi) !=
+                getLineClass(x, bounds.border.xLo, bounds.border.xHi, bounds.fill.xLo, bounds.fill.xHi))
+                dirtyColumns |= 1u << x;
+        }
+
+        DEMO_BG_BOX_PROFILER_START("map: clear");
+        for (int y = span.yLo; y <= span.yHi; ++y)
+            if (dirtyRows & (1u << y))
+                clearCells({span.xLo, span.xHi, int8_t(y), int8_t(y)});
+        for (int x = span.xLo; x <= span.xHi; ++x)
+            if (dirtyColumns & (1u << x))
+                clearCells({int8_t(x), int8_t(x), span.yLo, span.yHi});
+        DEMO_BG_BOX_PROFILER_STOP();
+
+        DEMO_BG_BOX_PROFILER_START("map: draw");
+        for (int y = span.yLo; y <= span.yHi; ++y)
+            if (dirtyRows & (1u << y))
+                drawMap(bounds, {span.xLo, span.xHi, int8_t(y), int8_t(y)});
+        for (int x = span.xLo; x <= span.xHi; ++x)
+            if (dirtyColumns & (1u << x))
+                drawMap(bounds, {int8_t(x), int8_t(x), span.yLo, span.yHi});
+        DEMO_BG_BOX_PROFILER_STOP();
+
+        DEMO_BG_BOX_PROFILER_START("used tile pos: update");
+        updateUsedTilePos(bounds);
+        DEMO_BG_BOX_PROFILER_STOP();
+
+        _drawnBounds = bounds;
+    }
 
     // plot dots in each unique tile
     DEMO_BG_BOX_PROFILER_START("tiles: plot");
@@ -132,76 +187,178 @@ BN_CODE_IWRAM void BgBox::redraw()
             if (tilePos.x < 0)
                 continue;
 
-            auto& tile = _tiles[i];
-            for (int y = 0; y < TILE_LEN; ++y)
-            {
-                const int pY = tilePos.y * TILE_LEN + y;
-                const int pX = tilePos.x * TILE_LEN;
-
-                tile.data[y] = (getPlotColor(pX + 0, pY, borderRect, fillRect, _fillColorIdx, _borderColorIdx) << 0u) |
-                               (getPlotColor(pX + 1, pY, borderRect, fillRect, _fillColorIdx, _borderColorIdx) << 4u) |
-                               (getPlotColor(pX + 2, pY, borderRect, fillRect, _fillColorIdx, _borderColorIdx) << 8u) |
-                               (getPlotColor(pX + 3, pY, borderRect, fillRect, _fillColorIdx, _borderColorIdx) << 12u) |
-                               (getPlotColor(pX + 4, pY, borderRect, fillRect, _fillColorIdx, _borderColorIdx) << 16u) |
-                               (getPlotColor(pX + 5, pY, borderRect, fillRect, _fillColorIdx, _borderColorIdx) << 20u) |
-                               (getPlotColor(pX + 6, pY, borderRect, fillRect, _fillColorIdx, _borderColorIdx) << 24u) |
-                               (getPlotColor(pX + 7, pY, borderRect, fillRect, _fillColorIdx, _borderColorIdx) << 28u);
-            }
+            // replot only if the sub-tile offsets of the edges are changed
+            const uint32_t plotKey = getPlotKey(tilePos.x, tilePos.y, borderRect, fillRect);
+            if (_plotKeys[i] == plotKey)
+                continue;
+
+            _plotKeys[i] = plotKey;
+            _dirtyTiles |= 1u << i;
+
+            plotBoxTile(_tiles[i], tilePos.x * TILE_LEN, tilePos.y * TILE_LEN, borderRect, _borderThickness,
+                        _fillColorIdx, _borderColorIdx);
         }
     }
     DEMO_BG_BOX_PROFILER_STOP();
+}
 
-    _map.reload_cells_ref();
+BN_CODE_IWRAM void BgBox::commit()
+{
+    DEMO_BG_BOX_PROFILER_START("vram: commit");
 
-#ifdef DEMO_BG_BOX_DEBUG
-    if (!_debug)
-#endif
-        _tileset.reload_tiles_ref();
+    bn::span<bn::regular_bg_map_cell> vramCells = *_map.vram();
+
+    // cells are kept as they're in VRAM, so each dirty span is copied as is
+    for (int y = 0; y < MAP_SIZE.height(); ++y)
+    {
+        CellSpan& dirtySpan = _dirtyCellSpans[y];
+
+        if (dirtySpan.xLo <= dirtySpan.xHi)
+        {
+            const int cellIdx = _mapItem.cell_index(dirtySpan.xLo, y);
+            bn::memory::copy(_cells[cellIdx], dirtySpan.xHi - dirtySpan.xLo + 1, vramCells[cellIdx]);
+        }
+
+        dirtySpan = {0, -1};
+    }
+
+    if (_dirtyTiles)
+    {
+        bn::span<bn::tile> vramTiles = *_tileset.vram();
+
+        for (int i = 0; i < UNIQUE_TILE_COUNT; ++i)
+        {
+            if (_dirtyTiles & (1u << i))
+                vramTiles[i] = _tiles[i];
+        }
+
+        _dirtyTiles = 0;
+    }
+
+    DEMO_BG_BOX_PROFILER_STOP();
+}
+
+BN_CODE_IWRAM void BgBox::markCellsDirty(int xLo, int xHi, int y)
+{
+    CellSpan& dirtySpan = _dirtyCellSpans[y];
+
+    if (dirtySpan.xLo > dirtySpan.xHi)
+    {
+        dirtySpan = {int8_t(xLo), int8_t(xHi)};
+    }
+    else
+    {
+        dirtySpan.xLo = int8_t(bn::min(int(dirtySpan.xLo), xLo));
+        dirtySpan.xHi = int8_t(bn::max(int(dirtySpan.xHi), xHi));
+    }
+}
+
+BN_CODE_IWRAM void BgBox::clearCells(const CellRect& clip)
+{
+    const int cellCount = clip.xHi - clip.xLo + 1;
+
+    for (int y = clip.yLo; y <= clip.yHi; ++y)
+    {
+        bn::memory::set_half_words(_tileCells[TileIdx::EMPTY], cellCount, &_cells[_mapItem.cell_index(clip.xLo, y)]);
+        markCellsDirty(clip.xLo, clip.xHi, y);
+    }
+}
+
+BN_CODE_IWRAM void BgBox::drawMap(const CellBounds& bounds, const CellRect& clip)
+{
+    // map: draw border sides
+    drawMapSides(clip, true, bounds.border);
+
+    // map: draw fill sides
+    drawMapSides(clip, false, bounds.fill);
+
+    // map: draw fill mid
+    const int yLo = bn::max(bounds.fill.yLo + 1, int(clip.yLo));
+    const int yHi = bn::min(bounds.fill.yHi - 1, int(clip.yHi));
+
+    for (int y = yLo; y <= yHi; ++y)
+        setCellLine(clip, bounds.fill.xLo + 1, bounds.fill.xHi - 1, y, TileIdx::MID_INNER);
 }
 
-BN_CODE_IWRAM void BgBox::setCell(int x, int y, int tileIdx)
+BN_CODE_IWRAM void BgBox::setCell(const CellRect& clip, int x, int y, int tileIdx)
 {
-    bn::regular_bg_map_cell& cell = _cells[_mapItem.cell_index(x, y)];
-    bn::regular_bg_map_cell_info cellInfo(cell);
-    cellInfo.set_tile_index(tileIdx);
-    cell = cellInfo.cell();
+    if (x < clip.xLo || x > clip.xHi || y < clip.yLo || y > clip.yHi)
+        return;
 
-    // cache an used tile pos
-    _usedTilePos[tileIdx] = {(int8_t)x, (int8_t)y};
+    _cells[_mapItem.cell_index(x, y)] = _tileCells[tileIdx];
+
+    markCellsDirty(x, x, y);
 }
 
-BN_CODE_IWRAM void BgBox::setCellLine(int xLo, int xHi, int y, int tileIdx)
+BN_CODE_IWRAM void BgBox::setCellLine(const CellRect& clip, int xLo, int xHi, int y, int tileIdx)
 {
+    if (y < clip.yLo || y > clip.yHi)
+        return;
+
+    xLo = bn::max(xLo, int(clip.xLo));
+    xHi = bn::min(xHi, int(clip.xHi));
+
     const int cellCount = xHi - xLo + 1;
     if (cellCount <= 0)
         return;
 
-    bn::regular_bg_map_cell& startCell = _cells[_mapItem.cell_index(xLo, y)];
-    bn::regular_bg_map_cell_info startCellInfo(startCell);
-    startCellInfo.set_tile_index(tileIdx);
-    bn::memory::set_half_words(startCellInfo.cell(), cellCount, &startCell);
+    bn::memory::set_half_words(_tileCells[tileIdx], cellCount, &_cells[_mapItem.cell_index(xLo, y)]);
 
-    // cache an used tile pos
-    _usedTilePos[tileIdx] = {(int8_t)xHi, (int8_t)y};
+    markCellsDirty(xLo, xHi, y);
 }
 
-BN_CODE_IWRAM void BgBox::drawMapSides(bool isOuter, int xLo, int xHi, int yLo, int yHi)
+BN_CODE_IWRAM void BgBox::drawMapSides(const CellRect& clip, bool isOuter, const CellRect& sides)
 {
     // sides
-    setCellLine(xLo + 1, xHi - 1, yLo, isOuter ? TileIdx::TOP_OUTER : TileIdx::TOP_INNER);
-    setCellLine(xLo + 1, xHi - 1, yHi, isOuter ? TileIdx::BOTTOM_OUTER : TileIdx::BOTTOM_INNER);
+    setCellLine(clip, sides.xLo + 1, sides.xHi - 1, sides.yLo, isOuter ? TileIdx::TOP_OUTER : TileIdx::TOP_INNER);
+    setCellLine(clip, sides.xLo + 1, sides.xHi - 1, sides.yHi,
+                isOuter ? TileIdx::BOTTOM_OUTER : TileIdx::BOTTOM_INNER);
+
+    const int yLo = bn::max(sides.yLo + 1, int(clip.yLo));
+    const int yHi = bn::min(sides.yHi - 1, int(clip.yHi));
 
-    for (int y = yLo + 1; y <= yHi - 1; ++y)
+    for (int y = yLo; y <= yHi; ++y)
     {
-        setCell(xLo, y, isOuter ? TileIdx::LEFT_OUTER : TileIdx::LEFT_INNER);
-        setCell(xHi, y, isOuter ? TileIdx::RIGHT_OUTER : TileIdx::RIGHT_INNER);
+        setCell(clip, sides.xLo, y, isOuter ? TileIdx::LEFT_OUTER : TileIdx::LEFT_INNER);
+        setCell(clip, sides.xHi, y, isOuter ? TileIdx::RIGHT_OUTER : TileIdx::RIGHT_INNER);
     }
 
     // corners
-    setCell(xLo, yLo, isOuter ? TileIdx::TOP_LEFT_OUTER : TileIdx::TOP_LEFT_INNER);
-    setCell(xHi, yLo, isOuter ? TileIdx::TOP_RIGHT_OUTER : TileIdx::TOP_RIGHT_INNER);
-    setCell(xLo, yHi, isOuter ? TileIdx::BOTTOM_LEFT_OUTER : TileIdx::BOTTOM_LEFT_INNER);
-    setCell(xHi, yHi, isOuter ? TileIdx::BOTTOM_RIGHT_OUTER : TileIdx::BOTTOM_RIGHT_INNER);
+    setCell(clip, sides.xLo, sides.yLo, isOuter ? TileIdx::TOP_LEFT_OUTER : TileIdx::TOP_LEFT_INNER);
+    setCell(clip, sides.xHi, sides.yLo, isOuter ? TileIdx::TOP_RIGHT_OUTER : TileIdx::TOP_RIGHT_INNER);
+    setCell(clip, sides.xLo, sides.yHi, isOuter ? TileIdx::BOTTOM_LEFT_OUTER : TileIdx::BOTTOM_LEFT_INNER);
+    setCell(clip, sides.xHi, sides.yHi, isOuter ? TileIdx::BOTTOM_RIGHT_OUTER : TileIdx::BOTTOM_RIGHT_INNER);
+}
+
+BN_CODE_IWRAM void BgBox::updateUsedTilePos(const CellBounds& bounds)
+{
+    BN_ASSERT(sizeof(_usedTilePos) % 4 == 0);
+    bn::memory::set_words(-1, sizeof(_usedTilePos) / 4, _usedTilePos);
+
+    // the last cell of each tile, in the order drawn by `drawMap()`
+    auto cacheSides = [this](bool isOuter, const CellRect& sides) {
+        if (sides.xHi - 1 >= sides.xLo + 1)
+        {
+            _usedTilePos[isOuter ? TileIdx::TOP_OUTER : TileIdx::TOP_INNER] = {int8_t(sides.xHi - 1), sides.yLo};
+            _usedTilePos[isOuter ? TileIdx::BOTTOM_OUTER : TileIdx::BOTTOM_INNER] = {int8_t(sides.xHi - 1),
+                                                                                      sides.yHi};
+        }
+        if (sides.yHi - 1 >= sides.yLo + 1)
+        {
+            _usedTilePos[isOuter ? TileIdx::LEFT_OUTER : TileIdx::LEFT_INNER] = {sides.xLo, int8_t(sides.yHi - 1)};
+            _usedTilePos[isOuter ? TileIdx::RIGHT_OUTER : TileIdx::RIGHT_INNER] = {sides.xHi, int8_t(sides.yHi - 1)};
+        }
+        _usedTilePos[isOuter ? TileIdx::TOP_LEFT_OUTER : TileIdx::TOP_LEFT_INNER] = {sides.xLo, sides.yLo};
+        _usedTilePos[isOuter ? TileIdx::TOP_RIGHT_OUTER : TileIdx::TOP_RIGHT_INNER] = {sides.xHi, sides.yLo};
+        _usedTilePos[isOuter ? TileIdx::BOTTOM_LEFT_OUTER : TileIdx::BOTTOM_LEFT_INNER] = {sides.xLo, sides.yHi};
+        _usedTilePos[isOuter ? TileIdx::BOTTOM_RIGHT_OUTER : TileIdx::BOTTOM_RIGHT_INNER] = {sides.xHi, sides.yHi};
+    };
+
+    cacheSides(true, bounds.border);
+    cacheSides(false, bounds.fill);
+
+    if (bounds.fill.yHi - 1 >= bounds.fill.yLo + 1 && bounds.fill.xHi - 1 >= bounds.fill.xLo + 1)
+        _usedTilePos[TileIdx::MID_INNER] = {int8_t(bounds.fill.xHi - 1), int8_t(bounds.fill.yHi - 1)};
 }
 
 } // namespace demo
@@ -5,6 +5,7 @@
 
 #include <bn_memory.h>
 #include <bn_regular_bg_item.h>
+#include <bn_regular_bg_map_cell_info.h>
 
 #ifdef DEMO_BG_BOX_DEBUG
 #include "bn_regular_bg_tiles_items_debug_numbers.h"
@@ -31,11 +32,14 @@ BgBox::BgBox(const bn::top_left_fixed_rect& boxRect, int borderThickness, bn::op
               return 0;
           return 1;
       }(borderThickness, borderColor.has_value())),
-      _fillColorIdx([](bool has_fill_color) { return has_fill_color ? 2 : 0; }(fillColor.has_value())), _cells{},
-      _tiles{}, _colors{}, _usedTilePos{}, _mapItem(_cells[0], MAP_SIZE),
+      _fillColorIdx([](bool has_fill_color) { return has_fill_color ? 2 : 0; }(fillColor.has_value())),
+      _moveByScrollEnabled(true), _scroll(0, 0), _cells{}, _tileCells{},
+      _tiles{}, _colors{}, _usedTilePos{}, _plotKeys{}, _dirtyCellSpans{},
+      _dirtyTiles(0), _drawnBounds{{-1, -1, -1, -1}, {-1, -1, -1, -1}}, _mapItem(_cells[0], MAP_SIZE),
       _palette(bn::bg_palette_item(_colors, bn::bpp_mode::BPP_4).create_new_palette()),
-      _tileset(bn::regular_bg_tiles_item(_tiles, bn::bpp_mode::BPP_4).create_tiles()),
-      _map(_mapItem.create_new_map(_tileset, _palette)), _bg(bn::regular_bg_ptr::create(0, 0, _map))
+      _tileset(bn::regular_bg_tiles_ptr::allocate(UNIQUE_TILE_COUNT, bn::bpp_mode::BPP_4)),
+      _map(bn::regular_bg_map_ptr::allocate(MAP_SIZE, _tileset, _palette)),
+      _bg(bn::regular_bg_ptr::create(0, 0, _map))
 {
     BN_ASSERT(0 <= borderThickness && borderThickness <= 8, "Invalid thickness: ", borderThickness);
 
@@ -56,13 +60,14 @@ BgBox::BgBox(const bn::top_left_fixed_rect& boxRect, int borderThickness, bn::op
 
     _palette.set_colors(bn::bg_palette_item(_colors, bn::bpp_mode::BPP_4));
 
+    // plot every used tile on the first redraw
+    bn::memory::set_words(0xFFFFFFFF, sizeof(_plotKeys) / 4, _plotKeys);
+
 #ifdef DEMO_BG_BOX_DEBUG
     if (debug)
     {
         for (int i = 0; i < UNIQUE_TILE_COUNT; ++i)
             _tiles[i] = bn::regular_bg_tiles_items::debug_numbers.tiles_ref()[i];
-
-        _tileset.reload_tiles_ref();
     }
     else
 #endif
@@ -74,7 +79,26 @@ BgBox::BgBox(const bn::top_left_fixed_rect& boxRect, int borderThickness, bn::op
         bn::memory::set_words(midColor, sizeof(_tiles[TileIdx::MID_INNER].data) / 4, _tiles[TileIdx::MID_INNER].data);
     }
 
+    // cells refer to the tiles & palette by their allocated position, which is fixed while the map is alive
+    for (int i = 0; i < UNIQUE_TILE_COUNT; ++i)
+    {
+        bn::regular_bg_map_cell_info cellInfo;
+        cellInfo.set_tile_index(_map.tiles_offset() + i);
+        cellInfo.set_palette_id(_map.palette_bank_offset());
+        _tileCells[i] = cellInfo.cell();
+    }
+
+    bn::memory::set_half_words(_tileCells[TileIdx::EMPTY], sizeof(_cells) / sizeof(_cells[0]), _cells);
+
+    // allocated VRAM is not cleared, so copy everything on the first commit
+    for (int y = 0; y < MAP_SIZE.height(); ++y)
+        markCellsDirty(0, MAP_SIZE.width() - 1, y);
+    _dirtyTiles = (1u << UNIQUE_TILE_COUNT) - 1;
+
     setRect(boxRect);
+
+    // not shown until the next `bn::core::update()`, so it's safe to copy here
+    commit();
 }
 
 auto BgBox::getRect() const -> const bn::top_left_fixed_rect&
@@ -107,8 +131,27 @@ void BgBox::setRect(const bn::top_left_fixed_rect& boxRect)
     BN_ASSERT(boxRect.height() >= 2 * _borderThickness, "height is too thin: ", boxRect.height(), " - ",
               2 * _borderThickness);
 
+    // only scroll the canvas if the whole box is drawn on the map both before & after
+    if (_moveByScrollEnabled && _rawRect.width() == boxRect.width() && _rawRect.height() == boxRect.height() &&
+        isInsideMap(_rawRect) && isInsideMap(boxRect))
+    {
+        _scroll.set_x(_scroll.x() + boxRect.x().floor_integer() - _rawRect.x().floor_integer());
+        _scroll.set_y(_scroll.y() + boxRect.y().floor_integer() - _rawRect.y().floor_integer());
+        _rawRect = boxRect;
+
+        _bg.set_position(_scroll.x(), _scroll.y());
+        return;
+    }
+
     _rawRect = boxRect;
 
+    // the map is drawn with the rect unscrolled
+    if (_scroll != bn::point(0, 0))
+    {
+        _scroll = bn::point(0, 0);
+        _bg.set_position(0, 0);
+    }
+
     redraw();
 }
 
@@ -138,6 +181,16 @@ int BgBox::getBorderThickness() const
     return _borderThickness;
 }
 
+bool BgBox::isMoveByScrollEnabled() const
+{
+    return _moveByScrollEnabled;
+}
+
+void BgBox::setMoveByScrollEnabled(bool enabled)
+{
+    _moveByScrollEnabled = enabled;
+}
+
 auto BgBox::getCanvas() -> bn::regular_bg_ptr&
 {
     return _bg;
@@ -174,6 +227,13 @@ auto BgBox::getClampedRect() const -> bn::top_left_fixed_rect
     return clamped;
 }
 
+bool BgBox::isInsideMap(const bn::top_left_fixed_rect& rawRect)
+{
+    // the wrapped copies of the canvas are out of the screen, as the map is larger than the screen
+    return rawRect.left() >= -MAP_LEN.width() / 2 && rawRect.right() <= MAP_LEN.width() / 2 &&
+           rawRect.top() >= -MAP_LEN.height() / 2 && rawRect.bottom() <= MAP_LEN.height() / 2;
+}
+
 auto BgBox::convertToPositiveRect(const bn::top_left_fixed_rect& rawRect) -> bn::top_left_fixed_rect
 {
     return bn::top_left_fixed_rect{
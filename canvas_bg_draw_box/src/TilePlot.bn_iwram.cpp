@@ -0,0 +1,194 @@
+// SPDX-FileCopyrightText: Copyright 2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "TilePlot.hpp"
+
+#include <bn_algorithm.h>
+#include <bn_point.h>
+
+namespace demo
+{
+
+namespace
+{
+
+constexpr int TILE_LEN = 8;
+
+#ifdef DEMO_BG_BOX_BENCHMARK_ENABLED
+// lower `n` nibbles set
+constexpr uint32_t NIBBLE_MASKS[TILE_LEN + 1] = {
+    0x00000000, 0x0000000F, 0x000000FF, 0x00000FFF, 0x0000FFFF, 0x000FFFFF, 0x00FFFFFF, 0x0FFFFFFF, 0xFFFFFFFF,
+};
+#endif
+
+// class of a dot on an axis, as a nibble.
+// a dot is in the fill if it is in the fill on both axes, so the classes of 2 axes are combined with `&`
+constexpr uint32_t DOT_OUTSIDE = 0;
+constexpr uint32_t DOT_BORDER = 1;
+constexpr uint32_t DOT_FILL = 3;
+
+// sub-tile offsets of an edge, clamped to `[-TILE_LEN, TILE_LEN]` for the low side, `[0, 2 * TILE_LEN]` for the high
+constexpr int EDGE_OFFSET_COUNT = 2 * TILE_LEN + 1;
+constexpr int THICKNESS_COUNT = TILE_LEN + 1;
+
+// dot classes of a tile row (or column), crossed by the low or high edge of a box
+struct EdgePatterns
+{
+    uint32_t lo[EDGE_OFFSET_COUNT][THICKNESS_COUNT];
+    uint32_t hi[EDGE_OFFSET_COUNT][THICKNESS_COUNT];
+};
+
+constexpr auto makeEdgePatterns() -> EdgePatterns
+{
+    EdgePatterns patterns{};
+
+    for (int offsetIdx = 0; offsetIdx < EDGE_OFFSET_COUNT; ++offsetIdx)
+    {
+        const int loEdge = offsetIdx - TILE_LEN;
+        const int hiEdge = offsetIdx;
+
+        for (int thickness = 0; thickness < THICKNESS_COUNT; ++thickness)
+        {
+            uint32_t lo = 0, hi = 0;
+
+            for (int i = 0; i < TILE_LEN; ++i)
+            {
+                const uint32_t loClass = (i < loEdge)               ? DOT_OUTSIDE
+                                         : (i < loEdge + thickness) ? DOT_BORDER
+                                                                    : DOT_FILL;
+                const uint32_t hiClass = (i >= hiEdge)               ? DOT_OUTSIDE
+                                         : (i >= hiEdge - thickness) ? DOT_BORDER
+                                                                     : DOT_FILL;
+
+                lo |= loClass << (4 * i);
+                hi |= hiClass << (4 * i);
+            }
+
+            patterns.lo[offsetIdx][thickness] = lo;
+            patterns.hi[offsetIdx][thickness] = hi;
+        }
+    }
+
+    return patterns;
+}
+
+constexpr EdgePatterns EDGE_PATTERNS = makeEdgePatterns();
+static_assert(sizeof(EDGE_PATTERNS) == EDGE_PATTERNS_ROM_SIZE);
+
+/// @brief Dot classes of a tile axis, which box edges are `lo` & `hi` (exclusive) relative to the tile.
+BN_CODE_IWRAM inline uint32_t getAxisDots(int lo, int hi, int thickness)
+{
+    const int loIdx = bn::clamp(lo, -TILE_LEN, TILE_LEN) + TILE_LEN;
+    const int hiIdx = bn::clamp(hi, 0, 2 * TILE_LEN);
+
+    return EDGE_PATTERNS.lo[loIdx][thickness] & EDGE_PATTERNS.hi[hiIdx][thickness];
+}
+
+/// @brief Remaps the dot classes to the color indices.
+BN_CODE_IWRAM inline uint32_t remapDots(uint32_t dots, uint32_t fillColorIdx, uint32_t borderColorIdx)
+{
+    // a dot is one of `0b00`, `0b01` or `0b11`, so a `1` nibble is left in each mask, which can't carry on multiply
+    const uint32_t fillDots = (dots >> 1) & 0x11111111u;
+    const uint32_t borderDots = (dots ^ (dots >> 1)) & 0x11111111u;
+
+    return (fillDots * fillColorIdx) | (borderDots * borderColorIdx);
+}
+
+#ifdef DEMO_BG_BOX_BENCHMARK_ENABLED
+/// @brief Nibble mask of the dots in `[left, right)` of a row starting at `tileX`.
+BN_CODE_IWRAM inline uint32_t getSpanMask(int tileX, const bn::top_left_rect& rect)
+{
+    const int lo = bn::clamp(rect.left() - tileX, 0, TILE_LEN);
+    const int hi = bn::clamp(rect.right() - tileX, 0, TILE_LEN);
+
+    return NIBBLE_MASKS[hi] & ~NIBBLE_MASKS[lo];
+}
+
+/// @brief All bits set if `dotY` is in `[top, bottom)` of `rect`, or `0` otherwise.
+BN_CODE_IWRAM inline uint32_t getRowMask(int dotY, const bn::top_left_rect& rect)
+{
+    // an unsigned compare tests both ends at once
+    return -uint32_t(unsigned(dotY - rect.top()) < unsigned(rect.height()));
+}
+
+BN_CODE_IWRAM inline uint8_t getPlotColor(int dotX, int dotY, const bn::top_left_rect& borderRect,
+                                          const bn::top_left_rect& fillRect, int fillColorIdx, int borderColorIdx)
+{
+    const bn::point dotPos(dotX, dotY);
+
+    if ((fillRect.left() <= dotPos.x() && dotPos.x() < fillRect.right()) &&
+        (fillRect.top() <= dotPos.y() && dotPos.y() < fillRect.bottom()))
+        return fillColorIdx;
+    if ((borderRect.left() <= dotPos.x() && dotPos.x() < borderRect.right()) &&
+        (borderRect.top() <= dotPos.y() && dotPos.y() < borderRect.bottom()))
+        return borderColorIdx;
+    return 0;
+}
+#endif // DEMO_BG_BOX_BENCHMARK_ENABLED
+
+} // namespace
+
+BN_CODE_IWRAM void plotBoxTile(bn::tile& tile, int tileX, int tileY, const bn::top_left_rect& borderRect,
+                               int borderThickness, int fillColorIdx, int borderColorIdx)
+{
+    const uint32_t xDots = getAxisDots(borderRect.left() - tileX, borderRect.right() - tileX, borderThickness);
+    const uint32_t yDots = getAxisDots(borderRect.top() - tileY, borderRect.bottom() - tileY, borderThickness);
+
+    // a row is outside, in the border band, or crosses the fill; indexed by the class of the row
+    const uint32_t rows[4] = {
+        0,
+        remapDots(xDots & 0x11111111u, fillColorIdx, borderColorIdx),
+        0,
+        remapDots(xDots, fillColorIdx, borderColorIdx),
+    };
+
+    for (int y = 0; y < TILE_LEN; ++y)
+        tile.data[y] = rows[(yDots >> (4 * y)) & 0xFu];
+}
+
+#ifdef DEMO_BG_BOX_BENCHMARK_ENABLED
+
+BN_CODE_IWRAM void plotTile(bn::tile& tile, int tileX, int tileY, const bn::top_left_rect& borderRect,
+                            const bn::top_left_rect& fillRect, int fillColorIdx, int borderColorIdx)
+{
+    // color index in every nibble
+    const uint32_t fillColors = uint32_t(fillColorIdx) * 0x11111111u;
+    const uint32_t borderColors = uint32_t(borderColorIdx) * 0x11111111u;
+
+    const uint32_t fillSpan = getSpanMask(tileX, fillRect);
+    const uint32_t borderSpan = getSpanMask(tileX, borderRect);
+
+    for (int y = 0; y < TILE_LEN; ++y)
+    {
+        const int dotY = tileY + y;
+
+        // fill is plotted over the border
+        const uint32_t fillMask = fillSpan & getRowMask(dotY, fillRect);
+        const uint32_t borderMask = borderSpan & getRowMask(dotY, borderRect) & ~fillMask;
+
+        tile.data[y] = (fillMask & fillColors) | (borderMask & borderColors);
+    }
+}
+
+BN_CODE_IWRAM void plotTilePerDot(bn::tile& tile, int tileX, int tileY, const bn::top_left_rect& borderRect,
+                                  const bn::top_left_rect& fillRect, int fillColorIdx, int borderColorIdx)
+{
+    for (int y = 0; y < TILE_LEN; ++y)
+    {
+        const int pY = tileY + y;
+        const int pX = tileX;
+
+        tile.data[y] = (getPlotColor(pX + 0, pY, borderRect, fillRect, fillColorIdx, borderColorIdx) << 0u) |
+                       (getPlotColor(pX + 1, pY, borderRect, fillRect, fillColorIdx, borderColorIdx) << 4u) |
+                       (getPlotColor(pX + 2, pY, borderRect, fillRect, fillColorIdx, borderColorIdx) << 8u) |
+                       (getPlotColor(pX + 3, pY, borderRect, fillRect, fillColorIdx, borderColorIdx) << 12u) |
+                       (getPlotColor(pX + 4, pY, borderRect, fillRect, fillColorIdx, borderColorIdx) << 16u) |
+                       (getPlotColor(pX + 5, pY, borderRect, fillRect, fillColorIdx, borderColorIdx) << 20u) |
+                       (getPlotColor(pX + 6, pY, borderRect, fillRect, fillColorIdx, borderColorIdx) << 24u) |
+                       (getPlotColor(pX + 7, pY, borderRect, fillRect, fillColorIdx, borderColorIdx) << 28u);
+    }
+}
+
+#endif // DEMO_BG_BOX_BENCHMARK_ENABLED
+
+} // namespace demo
@@ -7,11 +7,13 @@
 #include <bn_display.h>
 #include <bn_format.h>
 #include <bn_keypad.h>
+#include <bn_log.h>
 #include <bn_profiler.h>
 #include <bn_sprite_text_generator.h>
 #include <bn_unique_ptr.h>
 
 #include "BgBox.hpp"
+#include "Benchmarks.hpp"
 
 #include "common_info.h"
 #include "common_variable_8x16_sprite_font.h"
@@ -48,6 +50,9 @@ void moveAndScaleBgBoxScene(bn::sprite_text_generator& textGen, int& cpuUpdateCo
 #endif
 #if BN_CFG_PROFILER_ENABLED && defined(DEMO_BG_BOX_PROFILER_ENABLED)
         "R: profiler result",
+#endif
+#ifdef DEMO_BG_BOX_BENCHMARK_ENABLED
+        "SELECT: tile plot benchmark",
 #endif
     };
 
@@ -66,6 +71,10 @@ void moveAndScaleBgBoxScene(bn::sprite_text_generator& textGen, int& cpuUpdateCo
 
     int cpuUsageLogTimer = 30;
 
+#ifdef DEMO_BG_BOX_BENCHMARK_ENABLED
+    bn::vector<bn::sprite_ptr, 24> benchmarkSprites;
+#endif
+
     while (true)
     {
         constexpr bn::fixed MOVE_SPEED = 1.0f;
@@ -155,6 +164,26 @@ void moveAndScaleBgBoxScene(bn::sprite_text_generator& textGen, int& cpuUpdateCo
             bn::profiler::show();
 #endif
 
+#ifdef DEMO_BG_BOX_BENCHMARK_ENABLED
+        if (bn::keypad::select_pressed())
+        {
+            const bench::TilePlotResult result = bench::runTilePlot();
+
+            const auto text = bn::format<48>("{} tiles: {} -> {} cycles{}", result.tileCount, result.perDotCycles,
+                                             result.maskCycles, result.isSame ? "" : " (differ!)");
+            const auto tableText =
+                bn::format<48>("tables: {} cycles, {}B ROM", result.tableCycles, result.tableRomSize);
+
+            benchmarkSprites.clear();
+            textGen.set_left_alignment();
+            textGen.generate(-112, 52, text, benchmarkSprites);
+            textGen.generate(-112, 64, tableText, benchmarkSprites);
+
+            BN_LOG("tile plot: per dot -> mask, ", text);
+            BN_LOG("tile plot: edge pattern tables, ", tableText);
+        }
+#endif
+
 #ifdef DEMO_BG_BOX_DEBUG
         if (bn::keypad::l_pressed())
         {
@@ -166,6 +195,12 @@ void moveAndScaleBgBoxScene(bn::sprite_text_generator& textGen, int& cpuUpdateCo
         info.update();
         updateCpuUsageText(textGen, cpuUpdateCounter, maxCpuUsage, cpuSprites);
         bn::core::update();
+
+        // copy the changes while it's still in VBlank
+        box->commit();
+#ifdef DEMO_BG_BOX_DEBUG
+        debugBox->commit();
+#endif
     }
 }
 
@@ -0,0 +1,20 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+// Host stand-in of butano: only the pieces used by the task library.
+
+#pragma once
+
+#include <algorithm>
+
+#include "bn_common.h"
+
+namespace bn
+{
+
+using std::clamp;
+using std::max;
+using std::min;
+using std::swap;
+
+} // namespace bn
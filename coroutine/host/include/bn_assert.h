@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+// Host stand-in of butano: only the pieces used by the task library.
+
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+#include "bn_common.h"
+
+namespace bn::host
+{
+
+template <typename... Args>
+[[noreturn]] void fail(const char* file, int line, const char* condition, const Args&... args)
+{
+    std::cerr << file << ':' << line << ": " << condition;
+    if constexpr (sizeof...(args) > 0)
+    {
+        std::cerr << ": ";
+        ((std::cerr << args), ...);
+    }
+    std::cerr << std::endl;
+
+    std::abort();
+}
+
+} // namespace bn::host
+
+#define BN_ASSERT(condition, ...) \
+    do \
+    { \
+        if (!(condition)) [[unlikely]] \
+            ::bn::host::fail(__FILE__, __LINE__, #condition __VA_OPT__(, ) __VA_ARGS__); \
+    } while (false)
+
+#define BN_ERROR(...) ::bn::host::fail(__FILE__, __LINE__, "BN_ERROR" __VA_OPT__(, ) __VA_ARGS__)
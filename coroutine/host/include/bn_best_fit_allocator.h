@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+// Host stand-in of butano: only the pieces used by the task library.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bn_assert.h"
+
+namespace bn
+{
+
+/**
+ * @brief Best-fit allocator in a buffer given by the user, like `bn::best_fit_allocator`.
+ *
+ * Blocks are laid out back to back with a header each, and free neighbors are merged on `free()`,
+ * so that the fragmentation of `TaskHeap` behaves as on the device.
+ */
+class best_fit_allocator
+{
+public:
+    best_fit_allocator(void* start, int bytes)
+    {
+        const auto address = reinterpret_cast<uintptr_t>(start);
+        const auto alignedAddress = (address + ALIGNMENT - 1) & ~uintptr_t(ALIGNMENT - 1);
+
+        _begin = reinterpret_cast<uint8_t*>(alignedAddress);
+        _end = _begin + ((bytes - int(alignedAddress - address)) & ~(ALIGNMENT - 1));
+
+        BN_ASSERT(_end - _begin >= int(sizeof(Header)) + ALIGNMENT, "Buffer is too small: ", bytes);
+
+        Header& first = header(_begin);
+        first.bytes = int(_end - _begin);
+        first.prevBytes = 0;
+        first.isFree = true;
+    }
+
+    best_fit_allocator(const best_fit_allocator&) = delete;
+    best_fit_allocator& operator=(const best_fit_allocator&) = delete;
+
+public:
+    /// @return `nullptr` if there's no free block large enough
+    void* alloc(int bytes)
+    {
+        BN_ASSERT(bytes >= 0, "Invalid bytes: ", bytes);
+
+        const int blockBytes = int(sizeof(Header)) + ((bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
+
+        uint8_t* best = nullptr;
+        for (uint8_t* block = _begin; block != _end; block += header(block).bytes)
+        {
+            const Header& candidate = header(block);
+            if (candidate.isFree && candidate.bytes >= blockBytes && (!best || candidate.bytes < header(best).bytes))
+                best = block;
+        }
+
+        if (!best)
+            return nullptr;
+
+        Header& chosen = header(best);
+
+        // split the rest, if it's large enough to be allocated
+        if (chosen.bytes - blockBytes >= int(sizeof(Header)) + ALIGNMENT)
+        {
+            uint8_t* rest = best + blockBytes;
+            header(rest).bytes = chosen.bytes - blockBytes;
+            header(rest).prevBytes = blockBytes;
+            header(rest).isFree = true;
+
+            if (rest + header(rest).bytes != _end)
+                header(rest + header(rest).bytes).prevBytes = header(rest).bytes;
+
+            chosen.bytes = blockBytes;
+        }
+
+        chosen.isFree = false;
+        _usedBytes += chosen.bytes;
+        return best + sizeof(Header);
+    }
+
+    void free(void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        uint8_t* block = static_cast<uint8_t*>(ptr) - sizeof(Header);
+        BN_ASSERT(_begin <= block && block < _end && !header(block).isFree, "Invalid ptr");
+
+        header(block).isFree = true;
+        _usedBytes -= header(block).bytes;
+
+        // merge with the next block
+        uint8_t* next = block + header(block).bytes;
+        if (next != _end && header(next).isFree)
+            header(block).bytes += header(next).bytes;
+
+        // merge with the previous block
+        if (block != _begin && header(block - header(block).prevBytes).isFree)
+        {
+            uint8_t* prev = block - header(block).prevBytes;
+            header(prev).bytes += header(block).bytes;
+            block = prev;
+        }
+
+        next = block + header(block).bytes;
+        if (next != _end)
+            header(next).prevBytes = header(block).bytes;
+    }
+
+    int used_bytes() const
+    {
+        return _usedBytes;
+    }
+
+    int available_bytes() const
+    {
+        return int(_end - _begin) - _usedBytes;
+    }
+
+private:
+    static constexpr int ALIGNMENT = 8;
+
+    struct alignas(ALIGNMENT) Header
+    {
+        int bytes;
+        int prevBytes;
+        bool isFree;
+    };
+
+    static auto header(uint8_t* block) -> Header&
+    {
+        return *reinterpret_cast<Header*>(block);
+    }
+
+private:
+    uint8_t* _begin;
+    uint8_t* _end;
+    int _usedBytes = 0;
+};
+
+} // namespace bn
@@ -0,0 +1,10 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+// Host stand-in of butano: only the pieces used by the task library.
+
+#pragma once
+
+#define BN_CODE_IWRAM
+#define BN_CODE_EWRAM
+#define BN_DATA_EWRAM
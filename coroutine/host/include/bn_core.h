@@ -0,0 +1,19 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+// Host stand-in of butano: only the pieces used by the task library.
+
+#pragma once
+
+#include "bn_common.h"
+
+namespace bn::core
+{
+
+/// @brief There's no frame to miss on the host, as `TaskManager::update(int)` is driven by the benchmarks.
+inline int last_missed_frames()
+{
+    return 0;
+}
+
+} // namespace bn::core
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+// Host stand-in of butano: only the pieces used by the task library.
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "bn_common.h"
+
+namespace bn
+{
+
+/// @brief 20.12 fixed point number, like `bn::fixed`.
+class fixed
+{
+public:
+    static constexpr int PRECISION = 12;
+
+public:
+    constexpr fixed() = default;
+
+    constexpr fixed(int integer) : _data(integer << PRECISION)
+    {
+    }
+
+    static constexpr auto from_data(int data) -> fixed
+    {
+        fixed result;
+        result._data = data;
+        return result;
+    }
+
+    constexpr int data() const
+    {
+        return _data;
+    }
+
+    constexpr int integer() const
+    {
+        return _data / (1 << PRECISION);
+    }
+
+    friend constexpr auto operator+(fixed a, fixed b) -> fixed
+    {
+        return from_data(a._data + b._data);
+    }
+
+    friend constexpr auto operator-(fixed a, fixed b) -> fixed
+    {
+        return from_data(a._data - b._data);
+    }
+
+    friend constexpr bool operator==(fixed, fixed) = default;
+
+    friend auto operator<<(std::ostream& out, fixed value) -> std::ostream&
+    {
+        return out << double(value._data) / (1 << PRECISION);
+    }
+
+private:
+    int _data = 0;
+};
+
+} // namespace bn
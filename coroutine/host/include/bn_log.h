@@ -0,0 +1,25 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+// Host stand-in of butano: only the pieces used by the task library.
+
+#pragma once
+
+#include <iostream>
+
+#include "bn_common.h"
+
+namespace bn::host
+{
+
+template <typename... Args>
+void log(const Args&... args)
+{
+    ((std::cerr << args), ...);
+    std::cerr << '\n';
+}
+
+} // namespace bn::host
+
+// written to stderr, so that it's not mixed with the results on stdout
+#define BN_LOG(...) ::bn::host::log(__VA_ARGS__)
@@ -0,0 +1,25 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+// Host stand-in of butano: only the pieces used by the task library.
+
+#pragma once
+
+#include <cstdlib>
+
+#include "bn_common.h"
+
+namespace bn::memory
+{
+
+inline void* ewram_alloc(int bytes)
+{
+    return std::malloc(bytes);
+}
+
+inline void ewram_free(void* ptr)
+{
+    std::free(ptr);
+}
+
+} // namespace bn::memory
@@ -0,0 +1,18 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+// Host stand-in of butano: only the pieces used by the task library.
+
+#pragma once
+
+#include <span>
+
+#include "bn_common.h"
+
+namespace bn
+{
+
+template <typename Type>
+using span = std::span<Type>;
+
+} // namespace bn
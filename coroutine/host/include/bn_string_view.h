@@ -0,0 +1,17 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+// Host stand-in of butano: only the pieces used by the task library.
+
+#pragma once
+
+#include <string_view>
+
+#include "bn_common.h"
+
+namespace bn
+{
+
+using string_view = std::string_view;
+
+} // namespace bn
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+// Host stand-in of butano: only the pieces used by the task library.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "bn_common.h"
+
+namespace bn
+{
+
+namespace timers
+{
+
+// same as the GBA timer, which ticks every 64 CPU cycles
+constexpr int ticks_per_second()
+{
+    return 262144;
+}
+
+constexpr int ticks_per_frame()
+{
+    return 4389;
+}
+
+} // namespace timers
+
+/// @brief `std::chrono::steady_clock` counted in the ticks of the GBA timer.
+class timer
+{
+public:
+    timer() : _start(clock::now())
+    {
+    }
+
+    int elapsed_ticks() const
+    {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - _start);
+        return int(int64_t(elapsed.count()) * timers::ticks_per_second() / 1'000'000'000);
+    }
+
+    void restart()
+    {
+        _start = clock::now();
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    clock::time_point _start;
+};
+
+} // namespace bn
@@ -0,0 +1,380 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+// Host benchmark suite of the task library, which is the regression gate for scheduler changes.
+//
+// Usage: task_bench [--quick] [--baseline FILE [--tolerance PERCENT]] [--write-baseline FILE]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "TaskArena.hpp"
+#include "TaskHeap.hpp"
+#include "TaskManager.hpp"
+
+namespace bench
+{
+
+namespace
+{
+
+constexpr int SCHEDULER_TASK_COUNT = 4096;
+constexpr int SCHEDULER_SIGNAL_KEYS = 128;
+constexpr int SCHEDULER_SIGNAL_KEY_GROUPS = 4;
+constexpr int SCHEDULER_ARENA_SIZE = 4 * 1024 * 1024;
+
+static_assert(SCHEDULER_SIGNAL_KEYS / SCHEDULER_SIGNAL_KEY_GROUPS <= task::TaskSignalQueue::CAPACITY,
+              "Signals posted on an update overflow `TaskSignalQueue`");
+
+constexpr int ON_SIGNAL_TASK_COUNT = 2048;
+constexpr int ON_SIGNAL_KEYS = 256;
+
+// frame sizes of short tasks, walking tasks and a few odd big ones, same as the device benchmark
+constexpr int HEAP_FRAME_SIZES[] = {44, 60, 76, 148, 196, 196, 212, 300};
+constexpr int HEAP_LIVE_FRAMES = 96;
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double NS_NOISE_FLOOR = 5.0;
+
+struct Options
+{
+    bool quick = false;
+    int tolerancePercent = 50;
+    const char* baselinePath = nullptr;
+    const char* writeBaselinePath = nullptr;
+};
+
+struct Metric
+{
+    std::string name;
+    double value;
+    const char* unit;
+    bool isHigherBetter;
+
+    // changes within this are noise of the host, however large in percent (e.g. a few ns of a tiny op)
+    double noiseFloor = 0;
+};
+
+auto elapsedNs(Clock::time_point start) -> double
+{
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+/// @brief Fails the run right away, as the results can't be trusted.
+void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::fprintf(stderr, "check failed: %s\n", what);
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+auto timerWaiter(int64_t& resumeCount, int frames) -> task::Task
+{
+    while (true)
+    {
+        task::TimeAwaiter timeAwaiter(frames);
+        co_await timeAwaiter;
+        ++resumeCount;
+    }
+}
+
+auto signalWaiter(int64_t& resumeCount, int key) -> task::Task
+{
+    while (true)
+    {
+        task::NpcWalkEndAwaiter walkEndAwaiter(key);
+        co_await walkEndAwaiter;
+        ++resumeCount;
+    }
+}
+
+struct SchedulerResult
+{
+    double spawnNsPerTask;
+    double resumesPerSecond;
+    double teardownNsPerTask;
+    int peakArenaBytes;
+};
+
+/// @brief Thousands of tasks, half awaiting timers of 1~4 frames and half awaiting signals of keyed groups.
+auto runScheduler(int updates) -> SchedulerResult
+{
+    SchedulerResult result{};
+
+    task::TaskArena arena(SCHEDULER_ARENA_SIZE);
+    task::TaskManager taskManager(arena);
+
+    int64_t resumeCount = 0;
+    int64_t expectedResumeCount = 0;
+
+    auto start = Clock::now();
+    for (int i = 0; i < SCHEDULER_TASK_COUNT; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            const int frames = 1 + (i / 2) % 4;
+            taskManager.spawnTask([&resumeCount, frames] { return timerWaiter(resumeCount, frames); });
+            expectedResumeCount += updates / frames;
+        }
+        else
+        {
+            const int key = (i / 2) % SCHEDULER_SIGNAL_KEYS;
+            const int keyGroup = key % SCHEDULER_SIGNAL_KEY_GROUPS;
+            taskManager.spawnTask([&resumeCount, key] { return signalWaiter(resumeCount, key); });
+            expectedResumeCount += (updates - keyGroup + SCHEDULER_SIGNAL_KEY_GROUPS - 1) / SCHEDULER_SIGNAL_KEY_GROUPS;
+        }
+    }
+    result.spawnNsPerTask = elapsedNs(start) / SCHEDULER_TASK_COUNT;
+
+    check(arena.getOverflowCount() == 0, "scheduler tasks fit in the arena");
+
+    start = Clock::now();
+    for (int update = 0; update < updates; ++update)
+    {
+        for (int key = update % SCHEDULER_SIGNAL_KEY_GROUPS; key < SCHEDULER_SIGNAL_KEYS;
+             key += SCHEDULER_SIGNAL_KEY_GROUPS)
+        {
+            taskManager.postSignal(task::TaskSignal{.kind = task::TaskSignal::Kind::NPC_WALK_END, .key = key});
+        }
+
+        taskManager.update(1);
+    }
+    result.resumesPerSecond = double(resumeCount) * 1e9 / elapsedNs(start);
+
+    check(resumeCount == expectedResumeCount, "every timer & signal waiter is resumed exactly when expected");
+    check(taskManager.getTotalDeferredResumeCount() == 0, "no resume is deferred without a budget");
+
+    start = Clock::now();
+    taskManager.onSignal(task::TaskSignal{.kind = task::TaskSignal::Kind::SCENE_DESTROYED});
+    result.teardownNsPerTask = elapsedNs(start) / SCHEDULER_TASK_COUNT;
+
+    check(arena.getLiveCount() == 0 && arena.getUsedBytes() == 0, "arena is released on SCENE_DESTROYED");
+    result.peakArenaBytes = arena.getPeakBytes();
+
+    return result;
+}
+
+/// @brief Waiters resumed right away by `TaskManager::onSignal()`, without the queue.
+auto runOnSignal(int rounds) -> double
+{
+    task::TaskArena arena(SCHEDULER_ARENA_SIZE);
+    task::TaskManager taskManager(arena);
+
+    int64_t resumeCount = 0;
+    for (int i = 0; i < ON_SIGNAL_TASK_COUNT; ++i)
+        taskManager.spawnTask([&resumeCount, i] { return signalWaiter(resumeCount, i % ON_SIGNAL_KEYS); });
+
+    const auto start = Clock::now();
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (int key = 0; key < ON_SIGNAL_KEYS; ++key)
+            taskManager.onSignal(task::TaskSignal{.kind = task::TaskSignal::Kind::NPC_WALK_END, .key = key});
+    }
+    const double resumesPerSecond = double(resumeCount) * 1e9 / elapsedNs(start);
+
+    check(resumeCount == int64_t(rounds) * ON_SIGNAL_TASK_COUNT, "every signal waiter is resumed on each round");
+
+    taskManager.onSignal(task::TaskSignal{.kind = task::TaskSignal::Kind::SCENE_DESTROYED});
+    return resumesPerSecond;
+}
+
+struct AllocResult
+{
+    double allocNs;
+    double freeNs;
+};
+
+/// @brief Allocates a batch of frames of mixed sizes, then frees them in a shuffled order.
+template <typename Alloc, typename Free>
+auto runAllocFree(int rounds, Alloc alloc, Free free) -> AllocResult
+{
+    constexpr int FRAME_SIZE_COUNT = int(sizeof(HEAP_FRAME_SIZES) / sizeof(int));
+
+    void* frames[HEAP_LIVE_FRAMES];
+    int order[HEAP_LIVE_FRAMES];
+    for (int i = 0; i < HEAP_LIVE_FRAMES; ++i)
+        order[i] = (i * 37) % HEAP_LIVE_FRAMES;
+
+    double allocNs = 0;
+    double freeNs = 0;
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        auto start = Clock::now();
+        for (int i = 0; i < HEAP_LIVE_FRAMES; ++i)
+            frames[i] = alloc(HEAP_FRAME_SIZES[(i + round) % FRAME_SIZE_COUNT]);
+        allocNs += elapsedNs(start);
+
+        for (int i = 0; i < HEAP_LIVE_FRAMES; ++i)
+            check(frames[i] != nullptr, "alloc/free frames fit in the heap");
+
+        start = Clock::now();
+        for (int i : order)
+            free(frames[i], HEAP_FRAME_SIZES[(i + round) % FRAME_SIZE_COUNT]);
+        freeNs += elapsedNs(start);
+    }
+
+    const double opCount = double(rounds) * HEAP_LIVE_FRAMES;
+    return AllocResult{allocNs / opCount, freeNs / opCount};
+}
+
+auto runSuite(const Options& options) -> std::vector<Metric>
+{
+    // best of the repeats, to filter out the noise of the host
+    const int repeats = options.quick ? 1 : 9;
+    const int updates = options.quick ? 60 : 600;
+    const int onSignalRounds = options.quick ? 10 : 100;
+    const int allocRounds = options.quick ? 100 : 10000;
+
+    auto& heap = task::TaskHeap::instance();
+    const int heapUsedBefore = heap.getUsedBytes();
+
+    SchedulerResult scheduler{1e30, 0, 1e30, 0};
+    double onSignalResumesPerSecond = 0;
+    AllocResult heapAlloc{1e30, 1e30};
+    AllocResult arenaAlloc{1e30, 1e30};
+
+    for (int repeat = 0; repeat < repeats; ++repeat)
+    {
+        const SchedulerResult result = runScheduler(updates);
+        scheduler.spawnNsPerTask = std::min(scheduler.spawnNsPerTask, result.spawnNsPerTask);
+        scheduler.resumesPerSecond = std::max(scheduler.resumesPerSecond, result.resumesPerSecond);
+        scheduler.teardownNsPerTask = std::min(scheduler.teardownNsPerTask, result.teardownNsPerTask);
+        scheduler.peakArenaBytes = std::max(scheduler.peakArenaBytes, result.peakArenaBytes);
+
+        onSignalResumesPerSecond = std::max(onSignalResumesPerSecond, runOnSignal(onSignalRounds));
+
+        const AllocResult heapResult = runAllocFree(
+            allocRounds, [&heap](int bytes) { return heap.alloc(bytes); },
+            [&heap](void* ptr, int bytes) { heap.free(ptr, bytes); });
+        heapAlloc.allocNs = std::min(heapAlloc.allocNs, heapResult.allocNs);
+        heapAlloc.freeNs = std::min(heapAlloc.freeNs, heapResult.freeNs);
+
+        task::TaskArena arena(64 * 1024);
+        const AllocResult arenaResult = runAllocFree(
+            allocRounds, [&arena](int bytes) { return arena.alloc(bytes); },
+            [&arena](void* ptr, int bytes) { arena.free(ptr, bytes); });
+        arenaAlloc.allocNs = std::min(arenaAlloc.allocNs, arenaResult.allocNs);
+        arenaAlloc.freeNs = std::min(arenaAlloc.freeNs, arenaResult.freeNs);
+    }
+
+    check(heap.getUsedBytes() == heapUsedBefore, "every frame is freed back to TaskHeap");
+    check(heap.getFailedAllocCount() == 0, "no allocation of TaskHeap failed");
+
+    return {
+        {"scheduler.spawn", scheduler.spawnNsPerTask, "ns/task", false, NS_NOISE_FLOOR},
+        {"scheduler.update", scheduler.resumesPerSecond, "resumes/s", true},
+        {"scheduler.teardown", scheduler.teardownNsPerTask, "ns/task", false, NS_NOISE_FLOOR},
+        {"scheduler.peak_arena", double(scheduler.peakArenaBytes), "B", false},
+        {"on_signal", onSignalResumesPerSecond, "resumes/s", true},
+        {"heap.alloc", heapAlloc.allocNs, "ns", false, NS_NOISE_FLOOR},
+        {"heap.free", heapAlloc.freeNs, "ns", false, NS_NOISE_FLOOR},
+        {"frames.peak", double(heap.getPeakBytes()), "B", false},
+        {"arena.alloc", arenaAlloc.allocNs, "ns", false, NS_NOISE_FLOOR},
+        {"arena.free", arenaAlloc.freeNs, "ns", false, NS_NOISE_FLOOR},
+    };
+}
+
+auto readBaseline(const char* path) -> std::map<std::string, double>
+{
+    std::map<std::string, double> baseline;
+    std::ifstream file(path);
+    check(bool(file), "baseline file is readable");
+
+    std::string name, unit;
+    double value;
+    while (file >> name >> value >> unit)
+        baseline[name] = value;
+
+    return baseline;
+}
+
+/// @return Number of metrics regressed more than the tolerance.
+int compareBaseline(const std::vector<Metric>& metrics, const Options& options)
+{
+    const auto baseline = readBaseline(options.baselinePath);
+    int regressionCount = 0;
+
+    for (const Metric& metric : metrics)
+    {
+        const auto it = baseline.find(metric.name);
+        if (it == baseline.end() || it->second <= 0)
+            continue;
+
+        // positive if worse than the baseline
+        const double change = (metric.value - it->second) / it->second * 100;
+        const double regression = metric.isHigherBetter ? -change : change;
+
+        if (regression > options.tolerancePercent && std::abs(metric.value - it->second) > metric.noiseFloor)
+        {
+            std::printf("REGRESSION %s: %.1f -> %.1f %s (%+.1f%%)\n", metric.name.c_str(), it->second, metric.value,
+                        metric.unit, change);
+            ++regressionCount;
+        }
+    }
+
+    return regressionCount;
+}
+
+auto parseOptions(int argc, char* argv[]) -> Options
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = (i + 1 < argc);
+
+        if (std::strcmp(argv[i], "--quick") == 0)
+            options.quick = true;
+        else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue)
+            options.baselinePath = argv[++i];
+        else if (std::strcmp(argv[i], "--write-baseline") == 0 && hasValue)
+            options.writeBaselinePath = argv[++i];
+        else if (std::strcmp(argv[i], "--tolerance") == 0 && hasValue)
+            options.tolerancePercent = std::atoi(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    return options;
+}
+
+} // namespace
+
+} // namespace bench
+
+int main(int argc, char* argv[])
+{
+    const bench::Options options = bench::parseOptions(argc, argv);
+    const std::vector<bench::Metric> metrics = bench::runSuite(options);
+
+    for (const bench::Metric& metric : metrics)
+        std::printf("%-22s %14.1f %s\n", metric.name.c_str(), metric.value, metric.unit);
+
+    if (options.writeBaselinePath)
+    {
+        std::ofstream file(options.writeBaselinePath);
+        for (const bench::Metric& metric : metrics)
+            file << metric.name << ' ' << metric.value << ' ' << metric.unit << '\n';
+    }
+
+    if (options.baselinePath && bench::compareBaseline(metrics, options) > 0)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
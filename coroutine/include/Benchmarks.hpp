@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <cstdint>
+
+namespace bench
+{
+
+struct HeapChurnResult
+{
+    int allocCount;
+    int failedAllocCount;
+    int elapsedTicks;
+
+    int availableBytes;
+    int largestFreeBlock;
+};
+
+/**
+ * @brief Allocates & frees coroutine frames of mixed sizes in random order,
+ * like restarting `WalkingNinja::walk()` among other tasks, measured with `bn::timer`.
+ *
+ * @param useSlabs Whether to use `task::TaskSlabAllocator`, or `bn::best_fit_allocator` only.
+ */
+auto runHeapChurn(bool useSlabs) -> HeapChurnResult;
+
+struct SchedulerResult
+{
+    int taskCount;
+    int spawnTicks;
+
+    int updateCount;
+    int resumeCount;
+    int updateTicks;
+
+    // high-water mark of the arena, which the frames of the tasks are allocated from
+    int peakHeapBytes;
+
+    // frames allocated from `task::TaskHeap` then freed, apart from the tasks
+    int allocCount;
+    int allocTicks;
+    int freeTicks;
+
+    /// @brief Resumes per second, including the dispatch of the posted signals.
+    auto getResumesPerSecond() const -> int64_t;
+};
+
+/**
+ * @brief Spawns hundreds of tasks in a `task::TaskManager`, half awaiting timers and half awaiting signals,
+ * and runs its updates back to back, measured with `bn::timer`.
+ *
+ * Signals of a quarter of the signal waiters are posted on each update.
+ * The allocations & frees of `task::TaskHeap` are also measured apart from them.
+ *
+ * Thousands of tasks don't fit in EWRAM along with the scenes, so they're run by the host build in `host/`.
+ */
+auto runScheduler() -> SchedulerResult;
+
+struct GeneratorResult
+{
+    int valueCount;
+    int generatorTicks;
+    int stateMachineTicks;
+};
+
+/**
+ * @brief Pulls the same spawn pattern from a `task::Generator` and from a hand-written state machine,
+ * measured with `bn::timer`.
+ */
+auto runGenerator() -> GeneratorResult;
+
+} // namespace bench
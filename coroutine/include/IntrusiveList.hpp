@@ -0,0 +1,190 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <bn_assert.h>
+
+namespace task
+{
+
+/**
+ * @brief Link embedded in an object to put it in an `IntrusiveList`.
+ *
+ * It unlinks itself on destruction,
+ * so destroying a coroutine frame also removes the awaiters in it from the lists of `TaskManager`.
+ */
+class IntrusiveListNode
+{
+public:
+    IntrusiveListNode() = default;
+
+    ~IntrusiveListNode()
+    {
+        unlink();
+    }
+
+    IntrusiveListNode(const IntrusiveListNode&) = delete;
+    IntrusiveListNode& operator=(const IntrusiveListNode&) = delete;
+
+public:
+    bool isLinked() const
+    {
+        return _next != nullptr;
+    }
+
+    void unlink()
+    {
+        if (!isLinked())
+            return;
+
+        _prev->_next = _next;
+        _next->_prev = _prev;
+        _prev = nullptr;
+        _next = nullptr;
+    }
+
+private:
+    template <typename T>
+    friend class IntrusiveList;
+
+    IntrusiveListNode* _prev = nullptr;
+    IntrusiveListNode* _next = nullptr;
+};
+
+/**
+ * @brief Circular doubly linked list of objects derived from `IntrusiveListNode`.
+ *
+ * It doesn't own its nodes, and every operation except `clear()` is O(1).
+ */
+template <typename T>
+class IntrusiveList
+{
+public:
+    class iterator
+    {
+    public:
+        explicit iterator(IntrusiveListNode* node) : _node(node)
+        {
+        }
+
+        auto operator*() const -> T&
+        {
+            return static_cast<T&>(*_node);
+        }
+
+        auto operator->() const -> T*
+        {
+            return static_cast<T*>(_node);
+        }
+
+        auto operator++() -> iterator&
+        {
+            _node = _node->_next;
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return _node == other._node;
+        }
+
+    private:
+        IntrusiveListNode* _node;
+    };
+
+public:
+    IntrusiveList()
+    {
+        _head._prev = &_head;
+        _head._next = &_head;
+    }
+
+    ~IntrusiveList()
+    {
+        clear();
+    }
+
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+public:
+    bool empty() const
+    {
+        return _head._next == &_head;
+    }
+
+    auto begin() -> iterator
+    {
+        return iterator(_head._next);
+    }
+
+    auto end() -> iterator
+    {
+        return iterator(&_head);
+    }
+
+    auto front() -> T&
+    {
+        BN_ASSERT(!empty(), "List is empty");
+        return static_cast<T&>(*_head._next);
+    }
+
+    void pushFront(T& node)
+    {
+        link(node, &_head, _head._next);
+    }
+
+    void pushBack(T& node)
+    {
+        link(node, _head._prev, &_head);
+    }
+
+    auto popFront() -> T&
+    {
+        T& node = front();
+        node.unlink();
+        return node;
+    }
+
+    /// @brief Moves all nodes of `other` to the back of this list.
+    void spliceBack(IntrusiveList& other)
+    {
+        if (other.empty())
+            return;
+
+        IntrusiveListNode* first = other._head._next;
+        IntrusiveListNode* last = other._head._prev;
+
+        first->_prev = _head._prev;
+        last->_next = &_head;
+        _head._prev->_next = first;
+        _head._prev = last;
+
+        other._head._prev = &other._head;
+        other._head._next = &other._head;
+    }
+
+    /// @brief Unlinks all nodes. This is O(n).
+    void clear()
+    {
+        while (!empty())
+            _head._next->unlink();
+    }
+
+private:
+    static void link(IntrusiveListNode& node, IntrusiveListNode* prev, IntrusiveListNode* next)
+    {
+        BN_ASSERT(!node.isLinked(), "Node is already linked");
+
+        node._prev = prev;
+        node._next = next;
+        prev->_next = &node;
+        next->_prev = &node;
+    }
+
+private:
+    IntrusiveListNode _head;
+};
+
+} // namespace task
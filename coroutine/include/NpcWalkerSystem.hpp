@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <cstdint>
+
+#include <bn_fixed_point.h>
+#include <bn_sprite_ptr.h>
+#include <bn_sprite_tiles_ptr.h>
+#include <bn_vector.h>
+
+#include "Task.hpp"
+#include "TaskGroup.hpp"
+
+namespace task
+{
+class TaskManager;
+}
+
+/**
+ * @brief Many walking ninjas, stored as structure of arrays.
+ *
+ * Movement & animation of every walker are done in a single batched loop in `update()`,
+ * and a coroutine per walker only decides when to walk & where to.
+ * Unlike `WalkingNinja`, nothing is allocated per walk but the decision task frame.
+ */
+class NpcWalkerSystem
+{
+public:
+    static constexpr int MAX_WALKERS = 128;
+
+public:
+    NpcWalkerSystem(task::TaskManager&);
+
+    NpcWalkerSystem(const NpcWalkerSystem&) = delete;
+    NpcWalkerSystem& operator=(const NpcWalkerSystem&) = delete;
+
+public:
+    /// @brief Adds a walker, and starts its decision task.
+    /// @return the walker id, which is also the key of its `NPC_WALK_END` signal
+    int addWalker(const bn::fixed_point& initPos);
+
+    /// @brief Stops the walker by `NPC_WALK_END` signal, which is picked up by its decision task.
+    void stopWalker(int walkerId);
+
+    int size() const;
+
+    /**
+     * @brief Moves & animates every walking walker.
+     *
+     * The frames skipped since the last `bn::core::update()` are also counted,
+     * so that the walkers keep pace with the timers of their decision tasks on slowdown.
+     */
+    void update();
+
+    /// @brief Same as `update()`, but advances the walkers by `frames` instead.
+    BN_CODE_IWRAM void update(int frames);
+
+private:
+    // coroutine function to be suspended & resumed
+    auto decide(int walkerId) -> task::Task;
+
+    void startWalk(int walkerId);
+    void endWalk(int walkerId, bool arrived);
+
+private:
+    task::TaskManager& _taskManager;
+
+    // stop tiles first, and then left & right animation frames
+    bn::vector<bn::sprite_tiles_ptr, 9> _tiles;
+
+    int _size = 0;
+
+    bn::fixed _xs[MAX_WALKERS];
+    bn::fixed _velocityXs[MAX_WALKERS];
+    bn::fixed _prevXs[MAX_WALKERS];
+
+    // updates left until arrival, `0` if not walking
+    int16_t _remainingUpdates[MAX_WALKERS];
+
+    // `+1` for right, `-1` for left and `0` if never walked
+    int8_t _directions[MAX_WALKERS];
+
+    uint8_t _animWaitCounters[MAX_WALKERS];
+    uint8_t _animFrames[MAX_WALKERS];
+
+    bn::vector<bn::sprite_ptr, MAX_WALKERS> _sprites;
+
+    // declared last, so that the decision tasks are cancelled before the walkers are destroyed
+    task::TaskGroup _decisionTasks;
+};
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <bn_fixed.h>
+#include <bn_fixed_point.h>
+#include <bn_sprite_font.h>
+#include <bn_sprite_ptr.h>
+#include <bn_vector.h>
+
+/**
+ * @brief Center aligned number drawn with a persistent 8x16 sprite per glyph.
+ *
+ * Glyph tiles of digits, sign and decimal point are shared by every label of the same font,
+ * so changing the value only swaps the tiles of the glyphs changed, without generating text nor uploading tiles.
+ * Sprites are kept only for the glyphs of the current value, so a label without a value takes no OAM entry.
+ */
+class NumericLabel
+{
+public:
+    static constexpr int MAX_GLYPHS = 12;
+
+public:
+    /// @param font Font of 8x16 glyphs, which must be the same for every label.
+    NumericLabel(const bn::sprite_font& font, const bn::fixed_point& center);
+
+    NumericLabel(const NumericLabel&) = delete;
+    NumericLabel& operator=(const NumericLabel&) = delete;
+
+public:
+    void setValue(bn::fixed value);
+
+    /// @brief Moves the glyphs to be centered at `center`.
+    void setPosition(const bn::fixed_point& center);
+
+    void setVisible(bool visible);
+    void setBgPriority(int bgPriority);
+
+    /// @brief Glyph sprites of the current value.
+    auto sprites() const -> const bn::ivector<bn::sprite_ptr>&;
+
+    /// @brief Glyphs of the current value, which is the size of `sprites()`.
+    int glyphCount() const;
+
+private:
+    void layout();
+
+private:
+    const bn::sprite_font& _font;
+    bn::fixed_point _center;
+    bool _visible = true;
+    int _bgPriority = 3;
+
+    char _chars[MAX_GLYPHS] = {};
+    int _charCount = 0;
+
+    bn::vector<bn::sprite_ptr, MAX_GLYPHS> _sprites;
+};
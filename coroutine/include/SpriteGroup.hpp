@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <bn_assert.h>
+#include <bn_fixed_point.h>
+#include <bn_sprite_ptr.h>
+#include <bn_vector.h>
+
+/**
+ * @brief Sprites attached to an anchor, which keep their offsets from it.
+ *
+ * Moving the anchor writes the positions of every child at once,
+ * instead of interpolating each sprite with its own action.
+ */
+template <int MaxChildren>
+class SpriteGroup
+{
+public:
+    explicit SpriteGroup(const bn::fixed_point& position) : _position(position)
+    {
+    }
+
+public:
+    auto position() const -> const bn::fixed_point&
+    {
+        return _position;
+    }
+
+    void setPosition(const bn::fixed_point& position)
+    {
+        _position = position;
+
+        for (auto& child : _children)
+            child.sprite.set_position(position + child.offset);
+    }
+
+    /// @brief Attaches `sprite` at its current offset from the anchor.
+    void attach(const bn::sprite_ptr& sprite)
+    {
+        BN_ASSERT(!_children.full(), "Sprite group is full: ", MaxChildren);
+
+        _children.push_back(Child{sprite, sprite.position() - _position});
+    }
+
+    void clear()
+    {
+        _children.clear();
+    }
+
+private:
+    struct Child
+    {
+        bn::sprite_ptr sprite;
+        bn::fixed_point offset;
+    };
+
+private:
+    bn::fixed_point _position;
+    bn::vector<Child, MaxChildren> _children;
+};
+
+/// @brief Moves the anchor of `SpriteGroup` to a position, with a single interpolation for all children.
+template <int MaxChildren>
+class SpriteGroupMoveToAction
+{
+public:
+    SpriteGroupMoveToAction(SpriteGroup<MaxChildren>& group, int durationUpdates, const bn::fixed_point& finalPosition)
+        : _group(group), _finalPosition(finalPosition), _delta((finalPosition - group.position()) / durationUpdates),
+          _durationUpdates(durationUpdates)
+    {
+        BN_ASSERT(durationUpdates > 0, "Invalid duration updates: ", durationUpdates);
+    }
+
+public:
+    void update()
+    {
+        BN_ASSERT(!done(), "Action is done");
+
+        // snap to the final position at last, so that the error of `_delta` is not left
+        if (++_updates == _durationUpdates)
+            _group.setPosition(_finalPosition);
+        else
+            _group.setPosition(_group.position() + _delta);
+    }
+
+    bool done() const
+    {
+        return _updates >= _durationUpdates;
+    }
+
+private:
+    SpriteGroup<MaxChildren>& _group;
+    bn::fixed_point _finalPosition;
+    bn::fixed_point _delta;
+    int _durationUpdates;
+    int _updates = 0;
+};
@@ -4,12 +4,25 @@
 #pragma once
 
 #include <coroutine>
+#include <cstddef>
+#include <cstdint>
 
-#include "TaskSignal.hpp"
+#include "IntrusiveList.hpp"
 
 namespace task
 {
 
+class TaskManager;
+struct WaitNode;
+
+/// @brief Ready tasks of higher priority are resumed first by `TaskManager::update()`.
+enum class TaskPriority : uint8_t
+{
+    LOW,
+    NORMAL,
+    HIGH,
+};
+
 class Task
 {
 public:
@@ -17,22 +30,65 @@ public:
 
     using CoHandle = std::coroutine_handle<promise_type>;
 
-    struct promise_type
+    /**
+     * @brief Promise of a task, which is linked in the task list of `TaskManager` or `TaskGroup` that owns it.
+     *
+     * The list is intrusive, so the number of tasks is only bounded by the memory of `TaskHeap`.
+     */
+    struct promise_type : IntrusiveListNode
     {
-        TaskSignal taskSignal;
+        /**
+         * @brief Transfers to the awaiting task of a child task,
+         * or destroys the finished frame right away, if it's owned by `TaskManager` or `TaskGroup`.
+         */
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept;
+            auto await_suspend(CoHandle) noexcept -> std::coroutine_handle<>;
+            void await_resume() noexcept;
+        };
+
+        // set when added to `TaskManager`, or inherited from the awaiting task
+        TaskManager* taskManager = nullptr;
+        TaskPriority priority = TaskPriority::NORMAL;
+
+        // task awaiting this child task, which is resumed when this is finished
+        std::coroutine_handle<> continuation;
+
+        // set instead of `continuation`, if this child task is awaited by `whenAll()` or `whenAny()`
+        WaitNode* waitNode = nullptr;
+
+#ifdef TASK_TRACE_ENABLED
+        int16_t traceId = 0;
+#endif
 
         auto get_return_object() -> Task;
-        auto initial_suspend() -> std::suspend_never;
-        auto final_suspend() noexcept -> std::suspend_always;
+        auto initial_suspend() -> std::suspend_always;
+        auto final_suspend() noexcept -> FinalAwaiter;
         void unhandled_exception();
         void return_void();
 
-        void* operator new(unsigned bytes) noexcept;
-        void operator delete(void* ptr) noexcept;
+        void* operator new(std::size_t bytes) noexcept;
+        void operator delete(void* ptr, std::size_t bytes) noexcept;
 
         static auto get_return_object_on_allocation_failure() -> Task;
     };
 
+    /// @brief Starts a child task, and resumes the awaiting task when the child is finished.
+    class Awaiter
+    {
+    public:
+        Awaiter(CoHandle child);
+
+    public:
+        bool await_ready() const noexcept;
+        auto await_suspend(CoHandle parent) noexcept -> std::coroutine_handle<>;
+        void await_resume() noexcept;
+
+    private:
+        CoHandle _child;
+    };
+
 public:
     Task(CoHandle);
     ~Task();
@@ -47,7 +103,19 @@ public:
     bool done() const;
     void resume();
 
-    auto getTaskSignal() -> TaskSignal&;
+    auto getCoHandle() const -> CoHandle;
+
+    /// @brief Gives up the ownership of the coroutine frame.
+    auto release() -> CoHandle;
+
+    /**
+     * @brief Awaits this task as a child of the awaiting task.
+     *
+     * The child is not added to `TaskManager`, and its frame is still owned by this `Task`.
+     * Both starting the child and resuming the awaiting task are symmetric transfers,
+     * so that a deep chain of child tasks doesn't grow the stack.
+     */
+    auto operator co_await() const noexcept -> Awaiter;
 
 private:
     CoHandle _coHandle;
@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <utility>
+
+#include <bn_assert.h>
+
+#include "Task.hpp"
+#include "TaskManager.hpp"
+#include "TaskWaitNode.hpp"
+
+namespace task
+{
+
+/**
+ * @brief Awaits until an action is done. (e.g. `bn::sprite_move_to_action`)
+ *
+ * The action is updated by `TaskManager::update()` only while awaited,
+ * so the owner of the action doesn't need to poll it every frame.
+ * It's updated once per frame advanced, including the missed ones, so it keeps pace with `TimeAwaiter`.
+ *
+ * `Action` is any type with `update()` & `done()`, which is constructed in place.
+ */
+template <typename Action>
+class ActionAwaiter
+{
+public:
+    template <typename... Args>
+    explicit ActionAwaiter(Args&&... args) : _node(std::forward<Args>(args)...)
+    {
+    }
+
+public:
+    bool await_ready()
+    {
+        return _node.action.done();
+    }
+
+    void await_suspend(Task::CoHandle coHandle)
+    {
+        auto& promise = coHandle.promise();
+        BN_ASSERT(promise.taskManager, "Task is not added to `TaskManager`");
+
+        _node.coHandle = coHandle;
+        promise.taskManager->addActionWaiter(_node);
+    }
+
+    void await_resume()
+    {
+    }
+
+    auto getWaitNode() -> WaitNode&
+    {
+        return _node;
+    }
+
+    auto action() -> Action&
+    {
+        return _node.action;
+    }
+
+private:
+    struct Node final : ActionNode
+    {
+        template <typename... Args>
+        explicit Node(Args&&... args) : action(std::forward<Args>(args)...)
+        {
+        }
+
+        bool updateAction(int frames) override
+        {
+            for (int frame = 0; frame < frames && !action.done(); ++frame)
+                action.update();
+
+            return action.done();
+        }
+
+        Action action;
+    };
+
+private:
+    Node _node;
+};
+
+} // namespace task
@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <cstdint>
+
+#include "IntrusiveList.hpp"
+
+namespace task
+{
+
+/**
+ * @brief Bump allocator of coroutine frames, which is released all at once with `reset()`.
+ *
+ * Bind it to a `TaskManager` to allocate the frames of the tasks spawned by it from this,
+ * and the arena is reset on `SCENE_DESTROYED`.
+ *
+ * Freed frames are reused by the frames of the same size, so that respawning the same coroutine doesn't fill it up.
+ * When it's full, frames are allocated from the global `TaskHeap` instead, which is counted in `getOverflowCount()`.
+ */
+class TaskArena : public IntrusiveListNode
+{
+public:
+    /// @brief Allocates `bytes` of buffer from EWRAM.
+    explicit TaskArena(int bytes);
+    ~TaskArena();
+
+    TaskArena(const TaskArena&) = delete;
+    TaskArena& operator=(const TaskArena&) = delete;
+
+public:
+    /// @return `nullptr` if there's not enough space left
+    auto alloc(int bytes) -> void*;
+
+    /// @brief Reclaims the frame, unless `beginReset()` is called.
+    void free(void* ptr, int bytes);
+
+    /// @brief Frames freed until `reset()` are not reclaimed one by one, as they're released at once.
+    void beginReset();
+
+    /// @brief Releases every frame allocated. Frames must be destroyed beforehand.
+    void reset();
+
+    bool contains(const void* ptr) const;
+
+    int getUsedBytes() const;
+    int getMaxBytes() const;
+
+    /// @brief Highest `getUsedBytes()` so far, which is kept across `reset()`.
+    int getPeakBytes() const;
+
+    /// @brief Number of frames alive in this arena.
+    int getLiveCount() const;
+
+    /// @brief Number of allocations fallen back to the global `TaskHeap`, as this was full.
+    int getOverflowCount() const;
+
+private:
+    static constexpr int ALIGNMENT = 8;
+
+    static constexpr int NO_BLOCK = -1;
+
+    // stored in a freed frame, linked by the offsets from the buffer so that it fits in the alignment
+    struct FreeBlock
+    {
+        int nextOffset;
+        int bytes;
+    };
+
+    static_assert(sizeof(FreeBlock) <= ALIGNMENT);
+
+private:
+    uint8_t* _mem;
+    int _maxBytes;
+    int _usedBytes;
+    int _peakBytes = 0;
+
+    // offset of the first freed frame, or `NO_BLOCK`
+    int _freeBlockOffset = NO_BLOCK;
+
+    int _liveCount = 0;
+    int _overflowCount = 0;
+    bool _isResetting = false;
+};
+
+} // namespace task
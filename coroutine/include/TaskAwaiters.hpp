@@ -3,9 +3,13 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include <bn_fixed.h>
 
 #include "Task.hpp"
+#include "TaskSignalTable.hpp"
+#include "TaskTimerWheel.hpp"
 
 namespace task
 {
@@ -20,22 +24,45 @@ public:
     void await_suspend(task::Task::CoHandle coHandle);
     void await_resume();
 
+    auto getWaitNode() -> task::WaitNode&;
+
 private:
-    task::TaskSignal _signal;
+    task::SignalNode _node;
 };
 
 class TimeAwaiter
 {
 public:
-    TimeAwaiter(int ticks);
+    /// @brief Awaits for `frames` from the current frame of `TaskManager`.
+    TimeAwaiter(int frames);
+
+    /// @brief Awaits until the absolute `frame` of `TaskManager::getFrame()`.
+    static auto untilFrame(uint32_t frame) -> TimeAwaiter;
+
+    /**
+     * @brief Awaits until the absolute `ticks` of `TaskManager::getTicks()`.
+     *
+     * Task is resumed on the first update at or after `ticks`,
+     * so that a chain of deadlines spaced by sub-frame intervals doesn't drift.
+     */
+    static auto untilTicks(int64_t ticks) -> TimeAwaiter;
 
 public:
     bool await_ready() const;
-    void await_suspend(task::Task::CoHandle coHandle);
+    bool await_suspend(task::Task::CoHandle coHandle);
     void await_resume();
 
+    auto getWaitNode() -> task::WaitNode&;
+
+private:
+    TimeAwaiter(uint32_t frameOrFrames, bool isAbsolute);
+
 private:
-    int _ticks;
+    // relative frames, or the absolute frame if `_isAbsolute`
+    uint32_t _deadline;
+    bool _isAbsolute;
+
+    task::TimerNode _timer;
 };
 
 class NpcWalkEndAwaiter
@@ -50,9 +77,10 @@ public:
     /// @return the distance NPC walked
     auto await_resume() -> bn::fixed;
 
+    auto getWaitNode() -> task::WaitNode&;
+
 private:
-    int _npcId;
-    task::Task::CoHandle _coHandle;
+    task::SignalNode _node;
 };
 
 } // namespace task
@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+
+#include <bn_assert.h>
+
+#include "TaskHeap.hpp"
+
+namespace task
+{
+
+/**
+ * @brief Coroutine which lazily yields values of `T`, when they're pulled by `next()` or range-for.
+ *
+ * The frame is allocated from `TaskHeap` like `Task`, and nothing is allocated per value.
+ * It's not driven by `TaskManager`, so it can't `co_await` anything.
+ */
+template <typename T>
+class Generator
+{
+public:
+    struct promise_type;
+
+    using CoHandle = std::coroutine_handle<promise_type>;
+
+    struct promise_type
+    {
+        // points to the yielded value in the frame, which lives until the next resume
+        const T* value = nullptr;
+
+        auto get_return_object() -> Generator
+        {
+            return Generator(CoHandle::from_promise(*this));
+        }
+
+        auto initial_suspend() -> std::suspend_always
+        {
+            return {};
+        }
+
+        auto final_suspend() noexcept -> std::suspend_always
+        {
+            return {};
+        }
+
+        auto yield_value(const T& yielded) -> std::suspend_always
+        {
+            value = std::addressof(yielded);
+            return {};
+        }
+
+        void return_void()
+        {
+        }
+
+        void unhandled_exception()
+        {
+            BN_ERROR("Generator::promise_type has an unhandled exception");
+        }
+
+        template <typename Awaitable>
+        auto await_transform(Awaitable&&) -> std::suspend_never = delete;
+
+        void* operator new(std::size_t bytes) noexcept
+        {
+            auto& heap = TaskHeap::instance();
+
+            void* ptr = heap.alloc(int(bytes));
+            BN_ASSERT(ptr, "Generator alloc failed: req=", bytes, ", free=", heap.getAllocator().available_bytes());
+
+            return ptr;
+        }
+
+        void operator delete(void* ptr, std::size_t bytes) noexcept
+        {
+            TaskHeap::instance().free(ptr, int(bytes));
+        }
+
+        static auto get_return_object_on_allocation_failure() -> Generator
+        {
+            BN_ERROR("Generator alloc failed");
+            return Generator(nullptr);
+        }
+    };
+
+    class iterator
+    {
+    public:
+        using value_type = T;
+        using difference_type = int;
+
+    public:
+        iterator() = default;
+
+        explicit iterator(Generator& generator) : _generator(&generator)
+        {
+        }
+
+        auto operator*() const -> const T&
+        {
+            return _generator->value();
+        }
+
+        auto operator++() -> iterator&
+        {
+            _generator->next();
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        bool operator==(std::default_sentinel_t) const
+        {
+            return _generator->done();
+        }
+
+    private:
+        Generator* _generator = nullptr;
+    };
+
+public:
+    Generator(CoHandle coHandle) : _coHandle(coHandle)
+    {
+    }
+
+    ~Generator()
+    {
+        if (_coHandle)
+            _coHandle.destroy();
+    }
+
+    Generator(Generator&& other) noexcept : _coHandle(other._coHandle)
+    {
+        other._coHandle = nullptr;
+    }
+
+    Generator& operator=(Generator&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (_coHandle)
+                _coHandle.destroy();
+
+            _coHandle = other._coHandle;
+            other._coHandle = nullptr;
+        }
+        return *this;
+    }
+
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+public:
+    /// @brief Resumes until the next value is yielded.
+    /// @return `false` if the generator is finished instead
+    bool next()
+    {
+        BN_ASSERT(_coHandle, "Invalid generator");
+
+        if (_coHandle.done())
+            return false;
+
+        _coHandle.resume();
+        return !_coHandle.done();
+    }
+
+    /// @brief The last value yielded by `next()`.
+    auto value() const -> const T&
+    {
+        BN_ASSERT(_coHandle && !_coHandle.done(), "No value to get");
+
+        return *_coHandle.promise().value;
+    }
+
+    bool done() const
+    {
+        return !_coHandle || _coHandle.done();
+    }
+
+    /// @brief Pulls the first value, so iterate only once.
+    auto begin() -> iterator
+    {
+        next();
+        return iterator(*this);
+    }
+
+    auto end() -> std::default_sentinel_t
+    {
+        return std::default_sentinel;
+    }
+
+private:
+    CoHandle _coHandle;
+};
+
+} // namespace task
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <cstdint>
+
+#include "IntrusiveList.hpp"
+#include "Task.hpp"
+
+namespace task
+{
+
+class TaskGroup;
+
+/**
+ * @brief Handle to cancel the tasks added to a `TaskGroup` before this is made.
+ *
+ * Tasks added after the group is cancelled are not affected by the old tokens.
+ * It must not outlive the group.
+ */
+class CancellationToken
+{
+public:
+    /// @brief Token which is never cancelled.
+    CancellationToken() = default;
+
+public:
+    bool isCancelled() const;
+
+    /// @brief Cancels the group, if it's not cancelled since this token is made.
+    void cancel();
+
+private:
+    friend class TaskGroup;
+
+    CancellationToken(TaskGroup&, uint16_t generation);
+
+private:
+    TaskGroup* _group = nullptr;
+    uint16_t _generation = 0;
+};
+
+/**
+ * @brief Tasks owned together, which can be cancelled apart from the other tasks of `TaskManager`.
+ *
+ * Cancelling destroys the frames without resuming them, which is O(number of tasks in the group).
+ * The remaining tasks are cancelled on destruction, and also on `SCENE_DESTROYED`.
+ */
+class TaskGroup : public IntrusiveListNode
+{
+public:
+    explicit TaskGroup(TaskManager&);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+public:
+    /**
+     * @brief Takes the ownership of a lazily started task, and starts it right away.
+     *
+     * The frame is destroyed as soon as the task is finished, or the group is cancelled.
+     */
+    void addTask(task::Task&&, task::TaskPriority = task::TaskPriority::NORMAL);
+
+    /**
+     * @brief Destroys the frames of every unfinished task in this group.
+     *
+     * The awaiters in the frames are unlinked from `TaskManager` by their destructors.
+     * It must not be called by a task of this group, as its own frame would be destroyed.
+     */
+    void cancel();
+
+    auto getToken() -> CancellationToken;
+
+    bool empty() const;
+
+private:
+    friend class CancellationToken;
+
+    task::TaskManager& _taskManager;
+    task::IntrusiveList<task::Task::promise_type> _tasks;
+
+    // increased on each cancel, to expire the tokens made before
+    uint16_t _generation = 0;
+};
+
+} // namespace task
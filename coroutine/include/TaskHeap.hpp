@@ -4,12 +4,48 @@
 #pragma once
 
 #include <bn_best_fit_allocator.h>
+#include <bn_span.h>
+
+#include "IntrusiveList.hpp"
+#include "TaskArena.hpp"
+#include "TaskSlabAllocator.hpp"
 
 namespace task
 {
 
 class TaskHeap
 {
+public:
+    static constexpr int MAX_FRAME_SIZES = 16;
+
+    /// @brief Allocations of a frame size, which is usually of a coroutine function.
+    struct FrameSizeCount
+    {
+        int bytes;
+        int allocCount;
+        int liveCount;
+    };
+
+    /**
+     * @brief Binds an arena to allocate the coroutine frames from while this is alive,
+     * or `nullptr` to use the global heap.
+     *
+     * `TaskManager` binds its own arena only while it spawns or resumes its tasks,
+     * so that the frames of the other tasks are not allocated from it.
+     */
+    class ArenaScope
+    {
+    public:
+        explicit ArenaScope(TaskArena*);
+        ~ArenaScope();
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+    private:
+        TaskArena* const _prevArena;
+    };
+
 public:
     static auto instance() -> TaskHeap&;
 
@@ -17,12 +53,67 @@ private:
     TaskHeap();
 
 public:
+    /// @brief Allocates a coroutine frame from the bound arena if set and not full,
+    /// or else from the size-class slabs, or the best-fit heap for odd sizes.
+    auto alloc(int bytes) -> void*;
+
+    /// @param bytes Must be the same as the one passed to `alloc()`
+    void free(void* ptr, int bytes);
+
+    /// @brief Arena bound by the innermost `ArenaScope`, or `nullptr`.
+    auto getArena() const -> TaskArena*;
+
+    /// @brief Registers an arena, so that `free()` can find out the frames allocated from it.
+    void addArena(TaskArena&);
+
     auto getAllocator() -> bn::best_fit_allocator&;
     auto getAllocator() const -> const bn::best_fit_allocator&;
 
+public:
+    /// @brief Bytes of the coroutine frames alive, including the ones in arenas.
+    int getUsedBytes() const;
+
+    /// @brief Highest `getUsedBytes()` so far.
+    int getPeakBytes() const;
+
+    int getAllocCount() const;
+    int getFailedAllocCount() const;
+
+    /// @brief Allocations per frame size, in the order of the first allocation.
+    /// Sizes after the first `MAX_FRAME_SIZES` are not counted.
+    auto getFrameSizeCounts() const -> bn::span<const FrameSizeCount>;
+
+    /// @brief Largest block allocatable from the best-fit heap, which is compared to its available bytes
+    /// to measure the fragmentation.
+    /// This probes the allocator with a binary search, so don't call it every frame.
+    int getLargestFreeBlock();
+
+    /// @brief Largest block allocatable from `allocator`, found by binary search.
+    static int getLargestFreeBlock(bn::best_fit_allocator& allocator);
+
+    /// @brief Logs the stats & frame size histogram with `BN_LOG`.
+    void logStats();
+
+private:
+    void countAlloc(int bytes);
+    void countFree(int bytes);
+
 private:
-    uint8_t _mem[4096];
+    // enough for the coroutine frames of 64+ walkers in the stress scene, which hold their actions
+    uint8_t _mem[24576];
     bn::best_fit_allocator _alloc;
+    TaskSlabAllocator _slabAlloc;
+
+    IntrusiveList<TaskArena> _arenas;
+    TaskArena* _curArena = nullptr;
+
+    int _usedBytes = 0;
+    int _peakBytes = 0;
+    int _allocCount = 0;
+    int _failedAllocCount = 0;
+
+    FrameSizeCount _frameSizeCounts[MAX_FRAME_SIZES] = {};
+    int _frameSizeCountsSize = 0;
 };
 
 } // namespace task
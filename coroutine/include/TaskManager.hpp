@@ -3,28 +3,184 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
+#include <utility>
 
-#include <bn_forward_list.h>
+#include <bn_timer.h>
 
+#include "IntrusiveList.hpp"
 #include "Task.hpp"
+#include "TaskArena.hpp"
 #include "TaskAwaiters.hpp"
+#include "TaskHeap.hpp"
+#include "TaskSignalQueue.hpp"
+#include "TaskSignalTable.hpp"
+#include "TaskTimerWheel.hpp"
+#include "TaskWaitNode.hpp"
 
 namespace task
 {
 
+class TaskGroup;
+
 class TaskManager
 {
 public:
+    static constexpr int PRIORITY_COUNT = 3;
+
+public:
+    /// @brief Task manager which coroutine frames are allocated from the global `TaskHeap`.
+    TaskManager();
+
+    /**
+     * @brief Task manager bound to a scene-scoped `arena`.
+     *
+     * Coroutine frames of the tasks spawned with `spawnTask()`, and of their child tasks, are allocated from `arena`.
+     * It's reset at once on `SCENE_DESTROYED`, without reclaiming the frames one by one.
+     */
+    explicit TaskManager(task::TaskArena& arena);
+
+    ~TaskManager();
+
+    TaskManager(const TaskManager&) = delete;
+    TaskManager& operator=(const TaskManager&) = delete;
+
+public:
+    /**
+     * @brief Dispatches the posted signals, and resumes the tasks awaiting them
+     * or which deadline is reached, in priority order.
+     *
+     * Ready tasks not resumed within the budget are rolled over to the next update.
+     *
+     * The frames skipped since the last `bn::core::update()` are also counted,
+     * so that the timers and the awaited actions don't drift on slowdown.
+     */
     void update();
 
+    /// @brief Same as `update()`, but advances the clock by `frames` instead.
+    void update(int frames);
+
+public:
+    /// @brief Monotonic frame counter, which the deadlines of `TimeAwaiter` are based on.
+    auto getFrame() const -> uint32_t;
+
+    /// @brief `getFrame()` in `bn::timer` ticks, plus the ticks elapsed since the last update in this frame.
+    auto getTicks() const -> int64_t;
+
 public:
-    void addTask(task::Task&&);
+    /**
+     * @brief Takes the ownership of a lazily started task, and starts it right away.
+     *
+     * The frame is destroyed as soon as the task is finished.
+     */
+    void addTask(task::Task&&, task::TaskPriority = task::TaskPriority::NORMAL);
+
+    /**
+     * @brief Adds the task returned by `makeTask()`, which frame is allocated from the arena of this.
+     *
+     * e.g. `taskManager.spawnTask([this] { return walk(); });`
+     */
+    template <typename TaskFactory>
+    void spawnTask(TaskFactory&& makeTask, task::TaskPriority priority = task::TaskPriority::NORMAL)
+    {
+        task::Task task = [this, &makeTask]() -> task::Task {
+            TaskHeap::ArenaScope arenaScope(_arena);
+            return makeTask();
+        }();
 
+        addTask(std::move(task), priority);
+    }
+
+    /// @brief Dispatches a signal immediately, which resumes the tasks awaiting it right away.
     void onSignal(const task::TaskSignal&);
 
+    /**
+     * @brief Queues a signal to be dispatched in a batch on the next `update()`.
+     *
+     * Signals of the same kind & key posted before that are coalesced into one.
+     */
+    void postSignal(const task::TaskSignal&);
+
+public:
+    /// @brief Registers a timer of `TimeAwaiter`, which deadline must be after `getFrame()`.
+    void addTimer(task::TimerNode&);
+
+    /// @brief Parks a signal awaiter in the wait queue of its (`TaskSignal::Kind`, key).
+    void addSignalWaiter(task::SignalNode&);
+
+    /// @brief Parks an action awaiter, which action is updated on each `update()` until it's done.
+    void addActionWaiter(task::ActionNode&);
+
+public:
+    /// @brief Limits the number of resumes per `update()`, or `0` for no limit.
+    void setResumeBudget(int resumes);
+
+    /// @brief Limits the time spent on resuming per `update()` in `bn::timer` ticks, or `0` for no limit.
+    void setTickBudget(int ticks);
+
+    bool isLinearSignalScanEnabled() const;
+
+    /**
+     * @brief Dispatches each signal by scanning every signal awaiter, instead of only the ones of its key.
+     *
+     * Only to compare the cost with the keyed dispatch, e.g. in the walker stress test.
+     */
+    void setLinearSignalScanEnabled(bool enabled);
+
+    /// @brief Number of ready tasks rolled over to the next update by the last `update()`.
+    int getDeferredResumeCount() const;
+
+    /// @brief Number of ready tasks rolled over by every `update()` so far.
+    int getTotalDeferredResumeCount() const;
+
 private:
-    bn::forward_list<task::Task, 8> _tasks;
+    friend class TaskGroup;
+    friend struct WaitNode;
+
+    void startTask(task::Task&&, task::TaskPriority, task::IntrusiveList<task::Task::promise_type>& owner);
+    void addGroup(task::TaskGroup&);
+
+    void resumeTask(task::Task::CoHandle);
+    void resumeWaiter(task::WaitNode&);
+    void dispatchPendingSignals();
+    void updateActions(int frames);
+    void destroyAllTasks();
+    void cancelAllTasks();
+    void resumeReadyTasks();
+
+    void pushReadyNode(task::WaitNode&);
+    auto popReadyNode(task::IntrusiveList<task::WaitNode>& readyQueue) -> task::WaitNode&;
+    void dropReadyNode();
+
+private:
+    task::TaskTimerWheel _timerWheel;
+
+    // restarted on each update, for the sub-frame part of `getTicks()`
+    bn::timer _updateTimer;
+
+    // indexed by `TaskPriority`
+    task::IntrusiveList<task::WaitNode> _readyQueues[PRIORITY_COUNT];
+
+    task::TaskSignalTable _signalTable;
+    task::TaskSignalQueue _pendingSignals;
+
+    task::IntrusiveList<task::ActionNode> _actionWaiters;
+
+    // declared after the wait queues, as destroying a task unlinks the awaiters in its frame
+    task::IntrusiveList<task::Task::promise_type> _tasks;
+
+    // groups own their tasks apart from `_tasks`, to be cancelled without scanning the others
+    task::IntrusiveList<task::TaskGroup> _groups;
+
+    int _resumeBudget = 0;
+    int _tickBudget = 0;
+    // nodes in `_readyQueues`, kept on push & pop instead of walking the queues
+    int _readyNodeCount = 0;
+    int _deferredResumeCount = 0;
+    int _totalDeferredResumeCount = 0;
+
+    task::TaskArena* const _arena;
 };
 
 } // namespace task
@@ -3,20 +3,40 @@
 
 #pragma once
 
-#include <bn_any.h>
+#include <cstdint>
+
+#include <bn_fixed.h>
 
 namespace task
 {
 
+/// @brief Payload of `TaskSignal::Kind::NPC_WALK_END`
+struct NpcWalkEndPayload
+{
+    bn::fixed movedDistance;
+};
+
 struct TaskSignal
 {
-    enum class Kind;
+    enum class Kind : uint8_t;
+
+    /**
+     * @brief Payloads of every signal kind, which share the same storage.
+     *
+     * Signals without payload (`SCENE_DESTROYED`, `TIME`) don't have a member here.
+     */
+    union Payload {
+        NpcWalkEndPayload npcWalkEnd = {};
+    };
 
     Kind kind;
-    bn::any<16> argument;
-    bn::any<16> result;
 
-    enum class Kind
+    // Key of the wait queue in `TaskManager`. (e.g. NPC id)
+    int key = 0;
+
+    Payload payload = {};
+
+    enum class Kind : uint8_t
     {
         SCENE_DESTROYED,
         TIME,
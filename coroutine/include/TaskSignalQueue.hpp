@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include "TaskSignal.hpp"
+
+namespace task
+{
+
+/**
+ * @brief Fixed-capacity ring buffer of signals pending to be dispatched.
+ *
+ * Signals of the same (`TaskSignal::Kind`, key) are coalesced, and the last payload wins.
+ */
+class TaskSignalQueue
+{
+public:
+    static constexpr int CAPACITY = 64;
+
+public:
+    bool empty() const;
+    bool full() const;
+
+    /// @brief Pushes a signal, or overwrites the payload of the pending one with the same kind & key.
+    void push(const TaskSignal&);
+
+    auto pop() -> TaskSignal;
+
+    /// @brief Removes the pending signal with the same kind & key, if any.
+    void remove(TaskSignal::Kind kind, int key);
+
+private:
+    auto at(int index) -> TaskSignal&;
+
+private:
+    TaskSignal _signals[CAPACITY];
+    int _head = 0;
+    int _count = 0;
+};
+
+} // namespace task
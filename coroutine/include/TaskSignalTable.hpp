@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include "IntrusiveList.hpp"
+#include "TaskSignal.hpp"
+#include "TaskWaitNode.hpp"
+
+namespace task
+{
+
+struct SignalNode : WaitNode
+{
+    TaskSignal::Kind kind;
+    int key;
+
+    // written by `TaskManager::onSignal()` before resuming
+    TaskSignal::Payload payload;
+};
+
+/**
+ * @brief Hash table of wait queues keyed by (`TaskSignal::Kind`, key).
+ *
+ * Dispatching a signal only scans the bucket of its key, instead of every task in `TaskManager`.
+ * The linear scan mode puts every node in a single bucket, to compare with the keyed dispatch.
+ */
+class TaskSignalTable
+{
+public:
+    void add(SignalNode&);
+
+    /// @brief Moves the nodes awaiting (`kind`, `key`) to `matched`.
+    void take(TaskSignal::Kind kind, int key, IntrusiveList<SignalNode>& matched);
+
+    bool isLinearScanEnabled() const;
+
+    /// @brief Moves the parked nodes to the buckets of the new mode, keeping the order of each key.
+    void setLinearScanEnabled(bool enabled);
+
+private:
+    auto getBucket(TaskSignal::Kind kind, int key) -> IntrusiveList<SignalNode>&;
+
+    static auto getBucketIndex(TaskSignal::Kind kind, int key) -> int;
+
+private:
+    static constexpr int BUCKET_BITS = 6;
+    static constexpr int BUCKET_COUNT = 1 << BUCKET_BITS;
+
+private:
+    IntrusiveList<SignalNode> _buckets[BUCKET_COUNT];
+
+    bool _linearScanEnabled = false;
+};
+
+} // namespace task
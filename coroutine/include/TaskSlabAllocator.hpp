@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <bn_best_fit_allocator.h>
+
+namespace task
+{
+
+/**
+ * @brief Size-class allocator of coroutine frames.
+ *
+ * Frames up to `MAX_BLOCK_SIZE` bytes are rounded up to a multiple of `BLOCK_ALIGN` bytes,
+ * and each size class has its own free list, so `alloc()` & `free()` are O(1).
+ *
+ * When a size class runs out of blocks, a slab of `BLOCKS_PER_SLAB` blocks is carved from the fallback allocator.
+ * Slabs are never returned, so a block freed is only reused by the frames of the same size class.
+ * Frames bigger than `MAX_BLOCK_SIZE` go to the fallback allocator directly.
+ */
+class TaskSlabAllocator
+{
+public:
+    static constexpr int BLOCK_ALIGN = 32;
+    static constexpr int MAX_BLOCK_SIZE = 256;
+    static constexpr int BLOCKS_PER_SLAB = 4;
+
+public:
+    TaskSlabAllocator(bn::best_fit_allocator& fallback);
+
+    TaskSlabAllocator(const TaskSlabAllocator&) = delete;
+    TaskSlabAllocator& operator=(const TaskSlabAllocator&) = delete;
+
+public:
+    /// @return `nullptr` if allocation failed
+    auto alloc(int bytes) -> void*;
+
+    /// @param bytes Must be the same as the one passed to `alloc()`
+    void free(void* ptr, int bytes);
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+private:
+    static constexpr int SIZE_CLASS_COUNT = MAX_BLOCK_SIZE / BLOCK_ALIGN;
+
+    static auto getSizeClass(int bytes) -> int;
+    static auto getBlockSize(int sizeClass) -> int;
+
+    bool refill(int sizeClass);
+
+private:
+    bn::best_fit_allocator& _fallback;
+    FreeBlock* _freeLists[SIZE_CLASS_COUNT];
+};
+
+} // namespace task
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <cstdint>
+
+#include "IntrusiveList.hpp"
+#include "TaskWaitNode.hpp"
+
+namespace task
+{
+
+struct TimerNode : WaitNode
+{
+    uint32_t deadline;
+};
+
+/**
+ * @brief Hierarchical timer wheel of absolute frame deadlines.
+ *
+ * Each level has 16 slots, and a slot of level `L` spans `16^L` frames.
+ * Adding & removing a timer is O(1), and advancing a frame only touches the timers due,
+ * plus the timers cascading down from the upper levels once every 16 frames.
+ */
+class TaskTimerWheel
+{
+public:
+    auto now() const -> uint32_t;
+
+    /// @brief Adds a timer which `deadline` is after `now()`.
+    void add(TimerNode&);
+
+    /**
+     * @brief Advances to `frame`, and moves the timers due until then to `expired`.
+     *
+     * Skipped frames cost O(1) each, regardless of the number of timers.
+     */
+    void advanceTo(uint32_t frame, IntrusiveList<TimerNode>& expired);
+
+private:
+    void advance(IntrusiveList<TimerNode>& expired);
+    void addTimer(TimerNode&);
+    void cascade(int level);
+
+private:
+    static constexpr int LEVEL_BITS = 4;
+    static constexpr int LEVEL_COUNT = 4;
+    static constexpr int SLOT_COUNT = 1 << LEVEL_BITS;
+    static constexpr uint32_t SLOT_MASK = SLOT_COUNT - 1;
+    static constexpr uint32_t MAX_DELTA = (1u << (LEVEL_BITS * LEVEL_COUNT)) - 1;
+
+private:
+    uint32_t _now = 0;
+    IntrusiveList<TimerNode> _slots[LEVEL_COUNT][SLOT_COUNT];
+};
+
+} // namespace task
@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#ifdef TASK_TRACE_ENABLED
+
+#include <cstdint>
+
+#include <bn_timer.h>
+
+#include "TaskSignal.hpp"
+
+namespace task
+{
+
+/**
+ * @brief Records the lifecycle events of tasks into a ring buffer,
+ * which is dumped through `BN_LOG` as Chrome trace-event JSON. (`chrome://tracing` or Perfetto)
+ *
+ * Only compiled in if `TASK_TRACE_ENABLED` is defined.
+ */
+class TaskTrace
+{
+public:
+    static constexpr int CAPACITY = 1024;
+
+    enum class EventType : uint8_t
+    {
+        CREATE,
+        RESUME_BEGIN,
+        RESUME_END,
+        COMPLETE,
+        SIGNAL,
+        UPDATE_BEGIN,
+        UPDATE_END,
+    };
+
+    struct Event
+    {
+        int ticks;
+
+        // task id, or key of the signal
+        int16_t id;
+
+        EventType type;
+        TaskSignal::Kind signalKind;
+    };
+
+public:
+    static auto instance() -> TaskTrace&;
+
+private:
+    TaskTrace() = default;
+
+public:
+    auto newTaskId() -> int;
+
+    void record(EventType, int id, TaskSignal::Kind = TaskSignal::Kind::SCENE_DESTROYED);
+
+    /// @brief Logs the recorded events from the oldest one, and clears them.
+    void dump();
+
+    void clear();
+
+private:
+    bn::timer _timer;
+
+    Event _events[CAPACITY];
+    int _head = 0;
+    int _count = 0;
+
+    // `0` is used for `TaskManager` itself
+    int _nextTaskId = 1;
+};
+
+} // namespace task
+
+#define TASK_TRACE(type, id) \
+    do \
+    { \
+        task::TaskTrace::instance().record(task::TaskTrace::EventType::type, (id)); \
+    } while (false)
+#define TASK_TRACE_SIGNAL(signal) \
+    do \
+    { \
+        task::TaskTrace::instance().record(task::TaskTrace::EventType::SIGNAL, (signal).key, (signal).kind); \
+    } while (false)
+
+#else // ! TASK_TRACE_ENABLED
+
+#define TASK_TRACE(type, id) \
+    do \
+    { \
+    } while (false)
+#define TASK_TRACE_SIGNAL(signal) \
+    do \
+    { \
+    } while (false)
+
+#endif // TASK_TRACE_ENABLED
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include "IntrusiveList.hpp"
+#include "Task.hpp"
+
+namespace task
+{
+
+struct WaitNode;
+
+/// @brief Group of wait nodes which resume their task together. (e.g. `whenAll()`, `whenAny()`)
+class WaitGroup
+{
+public:
+    /// @return whether the task of `node` should be resumed now
+    virtual bool onWaitNodeReady(WaitNode& node) = 0;
+
+protected:
+    ~WaitGroup() = default;
+};
+
+/// @brief Node of an awaiter parked in `TaskManager`, to resume its task later.
+struct WaitNode : IntrusiveListNode
+{
+    Task::CoHandle coHandle;
+
+    // `nullptr` if the task is resumed as soon as this node is ready
+    WaitGroup* group = nullptr;
+
+    // set while queued in a ready queue of `TaskManager`, which keeps the count of them
+    bool isReady = false;
+
+    ~WaitNode();
+
+    /// @brief Unlinks this from the list of `TaskManager` it's parked in, or from its ready queue.
+    void unpark();
+};
+
+/// @brief Node of `ActionAwaiter`, which action is updated by `TaskManager` while parked.
+struct ActionNode : WaitNode
+{
+    /// @brief Updates the action once per frame, until it's done.
+    /// @return whether the action is done
+    virtual bool updateAction(int frames) = 0;
+
+protected:
+    ~ActionNode() = default;
+};
+
+} // namespace task
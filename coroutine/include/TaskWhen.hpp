@@ -0,0 +1,303 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <bn_assert.h>
+
+#include "Task.hpp"
+#include "TaskWaitNode.hpp"
+
+namespace task
+{
+
+/// @brief Branch of a wait group, which refers to an awaiter parking a `WaitNode` in `TaskManager`.
+template <typename Awaiter>
+class WaitBranch
+{
+public:
+    WaitBranch(Awaiter& awaiter) : _awaiter(awaiter)
+    {
+    }
+
+public:
+    bool ready()
+    {
+        return _awaiter.await_ready();
+    }
+
+    void start(WaitGroup& group, Task::CoHandle parent)
+    {
+        getWaitNode().group = &group;
+
+        // An awaiter which decided not to suspend (e.g. deadline already passed) is done right away.
+        if constexpr (std::is_same_v<decltype(_awaiter.await_suspend(parent)), bool>)
+        {
+            if (!_awaiter.await_suspend(parent))
+                group.onWaitNodeReady(getWaitNode());
+        }
+        else
+        {
+            _awaiter.await_suspend(parent);
+        }
+    }
+
+    void cancel()
+    {
+        getWaitNode().unpark();
+    }
+
+    void detach()
+    {
+        getWaitNode().group = nullptr;
+    }
+
+    auto getWaitNode() -> WaitNode&
+    {
+        return _awaiter.getWaitNode();
+    }
+
+private:
+    Awaiter& _awaiter;
+};
+
+/// @brief Branch of a wait group, which runs a child task.
+template <>
+class WaitBranch<Task>
+{
+public:
+    WaitBranch(Task& task) : _task(task)
+    {
+        BN_ASSERT(task.getCoHandle(), "Invalid task");
+        BN_ASSERT(!task.getCoHandle().promise().isLinked(), "Task is already added to `TaskManager`");
+    }
+
+public:
+    bool ready()
+    {
+        return _task.done();
+    }
+
+    void start(WaitGroup& group, Task::CoHandle parent)
+    {
+        auto& childPromise = _task.getCoHandle().promise();
+        childPromise.taskManager = parent.promise().taskManager;
+        childPromise.priority = parent.promise().priority;
+        childPromise.waitNode = &_node;
+
+        _node.coHandle = parent;
+        _node.group = &group;
+
+        // Not a symmetric transfer, as the other branches are started after this.
+        _task.getCoHandle().resume();
+    }
+
+    void cancel()
+    {
+        // Destroying the frame also unlinks the awaiters in it.
+        if (!_task.done())
+            _task = Task(nullptr);
+    }
+
+    void detach()
+    {
+        _node.group = nullptr;
+    }
+
+    auto getWaitNode() -> WaitNode&
+    {
+        return _node;
+    }
+
+private:
+    Task& _task;
+    WaitNode _node;
+};
+
+/**
+ * @brief Base of `WhenAll` & `WhenAny`, which holds the branches in the awaiting coroutine frame.
+ *
+ * Nothing is allocated, and the task is parked only once in `TaskManager` for all branches.
+ */
+template <typename... Awaiters>
+class BasicWaitGroup : public WaitGroup
+{
+    static_assert(sizeof...(Awaiters) > 0, "No awaiter to wait for");
+
+public:
+    explicit BasicWaitGroup(Awaiters&... awaiters) : _branches(awaiters...)
+    {
+    }
+
+    BasicWaitGroup(const BasicWaitGroup&) = delete;
+    BasicWaitGroup& operator=(const BasicWaitGroup&) = delete;
+
+protected:
+    ~BasicWaitGroup() = default;
+
+    template <typename Func>
+    void forEachBranch(Func&& func)
+    {
+        [this, &func]<std::size_t... Indexes>(std::index_sequence<Indexes...>) {
+            (func(std::get<Indexes>(_branches), int(Indexes)), ...);
+        }(std::index_sequence_for<Awaiters...>{});
+    }
+
+    void detachAll()
+    {
+        forEachBranch([](auto& branch, int) { branch.detach(); });
+    }
+
+protected:
+    // set while starting the branches, so that the awaiting task is not resumed in its own `await_suspend()`
+    bool _starting = false;
+
+private:
+    std::tuple<WaitBranch<Awaiters>...> _branches;
+};
+
+/// @brief Awaits until every awaiter is done.
+template <typename... Awaiters>
+class WhenAll final : public BasicWaitGroup<Awaiters...>
+{
+public:
+    using BasicWaitGroup<Awaiters...>::BasicWaitGroup;
+
+public:
+    bool await_ready()
+    {
+        bool allReady = true;
+        this->forEachBranch([&allReady](auto& branch, int) { allReady = allReady && branch.ready(); });
+        return allReady;
+    }
+
+    bool await_suspend(Task::CoHandle parent)
+    {
+        this->_starting = true;
+        this->forEachBranch([this, parent](auto& branch, int) {
+            if (!branch.ready())
+            {
+                ++_remaining;
+                branch.start(*this, parent);
+            }
+        });
+        this->_starting = false;
+
+        return _remaining > 0;
+    }
+
+    void await_resume()
+    {
+        this->detachAll();
+    }
+
+    bool onWaitNodeReady(WaitNode&) override
+    {
+        BN_ASSERT(_remaining > 0, "Every branch is already done");
+
+        return --_remaining == 0 && !this->_starting;
+    }
+
+private:
+    int _remaining = 0;
+};
+
+/// @brief Awaits until any of the awaiters is done, and cancels the others.
+template <typename... Awaiters>
+class WhenAny final : public BasicWaitGroup<Awaiters...>
+{
+public:
+    using BasicWaitGroup<Awaiters...>::BasicWaitGroup;
+
+public:
+    bool await_ready()
+    {
+        this->forEachBranch([this](auto& branch, int index) {
+            if (_winner < 0 && branch.ready())
+                _winner = index;
+        });
+        return _winner >= 0;
+    }
+
+    bool await_suspend(Task::CoHandle parent)
+    {
+        this->_starting = true;
+        this->forEachBranch([this, parent](auto& branch, int) {
+            if (_winner < 0)
+                branch.start(*this, parent);
+        });
+        this->_starting = false;
+
+        if (_winner < 0)
+            return true;
+
+        cancelLosers();
+        return false;
+    }
+
+    /// @return the index of the awaiter done first
+    int await_resume()
+    {
+        this->detachAll();
+        return _winner;
+    }
+
+    bool onWaitNodeReady(WaitNode& node) override
+    {
+        BN_ASSERT(_winner < 0, "Winner is already decided: ", _winner);
+
+        this->forEachBranch([this, &node](auto& branch, int index) {
+            if (&branch.getWaitNode() == &node)
+                _winner = index;
+        });
+
+        if (this->_starting)
+            return false;
+
+        cancelLosers();
+        return true;
+    }
+
+private:
+    void cancelLosers()
+    {
+        this->forEachBranch([this](auto& branch, int index) {
+            if (index != _winner)
+                branch.cancel();
+        });
+    }
+
+private:
+    int _winner = -1;
+};
+
+/**
+ * @brief Awaits until every awaiter is done.
+ *
+ * Awaiters are `TimeAwaiter`, `SignalAwaiter`, `NpcWalkEndAwaiter` or child `Task`,
+ * which live in the awaiting coroutine frame to get their results after this.
+ */
+template <typename... Awaiters>
+auto whenAll(Awaiters&... awaiters) -> WhenAll<Awaiters...>
+{
+    return WhenAll<Awaiters...>(awaiters...);
+}
+
+/**
+ * @brief Awaits until any of the awaiters is done, and returns its index.
+ *
+ * The others are cancelled, which unlinks their nodes and destroys the frames of child tasks.
+ * A child task must not make the other branches ready by itself, as it would be destroyed while running.
+ */
+template <typename... Awaiters>
+auto whenAny(Awaiters&... awaiters) -> WhenAny<Awaiters...>
+{
+    return WhenAny<Awaiters...>(awaiters...);
+}
+
+} // namespace task
@@ -4,12 +4,12 @@
 #pragma once
 
 #include <bn_optional.h>
-#include <bn_sprite_actions.h>
-#include <bn_sprite_animate_actions.h>
-#include <bn_sprite_text_generator.h>
-#include <bn_vector.h>
+#include <bn_sprite_font.h>
 
+#include "NumericLabel.hpp"
+#include "SpriteGroup.hpp"
 #include "Task.hpp"
+#include "TaskSignal.hpp"
 
 #include "bn_sprite_items_ninja.h"
 
@@ -33,40 +33,46 @@ public:
     static constexpr bn::fixed RIGHT_MOST_X = +80;
 
 public:
-    WalkingNinja(int npcId, const bn::fixed_point& initPos, task::TaskManager&, bn::sprite_text_generator&);
+    WalkingNinja(int npcId, const bn::fixed_point& initPos, task::TaskManager&, const bn::sprite_font&);
+
+    /// @brief Ninja without the distance text, to save sprites when there are many ninjas.
+    WalkingNinja(int npcId, const bn::fixed_point& initPos, task::TaskManager&);
 
     WalkingNinja(const WalkingNinja&) = delete;
     WalkingNinja& operator=(const WalkingNinja&) = delete;
 
 public:
-    void update();
-
     void changeWalkDirection();
     void stopWalk();
 
+    bool isWalking() const;
+
 private:
     // coroutine function to be suspended & resumed
     auto walk() -> task::Task;
 
+    /// @brief Attaches the ninja & the glyphs in use of the distance label to the sprite group.
+    void attachLabelGlyphs();
+
+    auto makeWalkEndSignal() const -> task::TaskSignal;
+
     auto leftMostPos() -> bn::fixed_point;
     auto rightMostPos() -> bn::fixed_point;
 
-private:
-    static constexpr int TEXT_SPR_CNT = 16;
-
 private:
     const int _npcId;
     task::TaskManager& _taskManager;
 
-    bn::sprite_text_generator& _textGen;
-
     Direction _prevDirection;
     bn::fixed _prevX;
 
+    bool _isWalking = false;
+
     bn::sprite_ptr _sprite;
-    bn::optional<bn::sprite_animate_action<4>> _spriteAnimAction;
-    bn::optional<bn::sprite_move_to_action> _spriteMoveAction;
 
-    bn::vector<bn::sprite_ptr, 16> _distanceTexts;
-    bn::vector<bn::sprite_move_to_action, 16> _distanceTextMoveActions;
+    // `bn::nullopt` if the distance text is not shown
+    bn::optional<NumericLabel> _distanceLabel;
+
+    // ninja sprite & distance label glyphs in use, moved together
+    SpriteGroup<1 + NumericLabel::MAX_GLYPHS> _spriteGroup;
 };
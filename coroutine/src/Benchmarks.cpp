@@ -0,0 +1,293 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "Benchmarks.hpp"
+
+#include <bn_best_fit_allocator.h>
+#include <bn_random.h>
+#include <bn_timer.h>
+#include <bn_unique_ptr.h>
+
+#include "TaskArena.hpp"
+#include "TaskGenerator.hpp"
+#include "TaskHeap.hpp"
+#include "TaskManager.hpp"
+#include "TaskSlabAllocator.hpp"
+
+namespace bench
+{
+
+namespace
+{
+
+constexpr int CHURN_HEAP_SIZE = 8192;
+constexpr int CHURN_LIVE_FRAMES = 40;
+constexpr int CHURN_STEPS = 2000;
+
+// frame sizes of short tasks, walking tasks and a few odd big ones
+constexpr int CHURN_FRAME_SIZES[] = {44, 60, 76, 148, 196, 196, 212, 300};
+
+constexpr int PATTERN_WAVES = 64;
+constexpr int PATTERN_SPAWNS_PER_WAVE = 32;
+constexpr int PATTERN_MAX_X = 240;
+
+constexpr int SCHEDULER_ARENA_SIZE = 48 * 1024;
+constexpr int SCHEDULER_TASK_COUNT = 384;
+constexpr int SCHEDULER_SIGNAL_KEY_GROUPS = 4;
+constexpr int SCHEDULER_UPDATES = 120;
+constexpr int SCHEDULER_ALLOC_COUNT = 64;
+
+static_assert(SCHEDULER_TASK_COUNT / 2 / SCHEDULER_SIGNAL_KEY_GROUPS <= task::TaskSignalQueue::CAPACITY,
+              "Signals posted on an update overflow `TaskSignalQueue`");
+
+struct ChurnHeap
+{
+    alignas(8) uint8_t mem[CHURN_HEAP_SIZE];
+};
+
+/// @brief x positions of spawns, which sweep back and forth with the speed of each wave.
+auto spawnPattern() -> task::Generator<int>
+{
+    for (int wave = 0; wave < PATTERN_WAVES; ++wave)
+    {
+        const int speed = 1 + wave % 8;
+        int x = 0;
+        int dx = speed;
+
+        for (int spawn = 0; spawn < PATTERN_SPAWNS_PER_WAVE; ++spawn)
+        {
+            co_yield x;
+
+            x += dx * 8;
+            if (x < 0 || x > PATTERN_MAX_X)
+            {
+                dx = -dx;
+                x += dx * 16;
+            }
+        }
+    }
+}
+
+/// @brief Same as `spawnPattern()`, but every local is kept in the members to resume from.
+class SpawnPatternStateMachine
+{
+public:
+    bool next()
+    {
+        if (_wave >= PATTERN_WAVES)
+            return false;
+
+        if (_spawn == PATTERN_SPAWNS_PER_WAVE)
+        {
+            _spawn = 0;
+            if (++_wave >= PATTERN_WAVES)
+                return false;
+        }
+
+        if (_spawn == 0)
+        {
+            _x = 0;
+            _dx = 1 + _wave % 8;
+        }
+        else
+        {
+            _x += _dx * 8;
+            if (_x < 0 || _x > PATTERN_MAX_X)
+            {
+                _dx = -_dx;
+                _x += _dx * 16;
+            }
+        }
+
+        ++_spawn;
+        return true;
+    }
+
+    int value() const
+    {
+        return _x;
+    }
+
+private:
+    int _wave = 0;
+    int _spawn = 0;
+    int _x = 0;
+    int _dx = 0;
+};
+
+auto timerWaiter(int& resumeCount, int ticks) -> task::Task
+{
+    while (true)
+    {
+        task::TimeAwaiter timeAwaiter(ticks);
+        co_await timeAwaiter;
+        ++resumeCount;
+    }
+}
+
+auto signalWaiter(int& resumeCount, int key) -> task::Task
+{
+    while (true)
+    {
+        task::NpcWalkEndAwaiter walkEndAwaiter(key);
+        co_await walkEndAwaiter;
+        ++resumeCount;
+    }
+}
+
+} // namespace
+
+auto SchedulerResult::getResumesPerSecond() const -> int64_t
+{
+    if (updateTicks <= 0)
+        return 0;
+
+    return int64_t(resumeCount) * bn::timers::ticks_per_second() / updateTicks;
+}
+
+auto runHeapChurn(bool useSlabs) -> HeapChurnResult
+{
+    bn::unique_ptr<ChurnHeap> heap(new ChurnHeap());
+    bn::best_fit_allocator bestFit(heap->mem, sizeof(heap->mem));
+    task::TaskSlabAllocator slabs(bestFit);
+
+    void* frames[CHURN_LIVE_FRAMES] = {};
+    int frameSizes[CHURN_LIVE_FRAMES] = {};
+
+    HeapChurnResult result{};
+    bn::random random;
+    bn::timer timer;
+
+    for (int step = 0; step < CHURN_STEPS; ++step)
+    {
+        const int slot = random.get_int(CHURN_LIVE_FRAMES);
+        const int bytes = CHURN_FRAME_SIZES[random.get_int(int(sizeof(CHURN_FRAME_SIZES) / sizeof(int)))];
+
+        if (frames[slot])
+        {
+            if (useSlabs)
+                slabs.free(frames[slot], frameSizes[slot]);
+            else
+                bestFit.free(frames[slot]);
+        }
+
+        frames[slot] = useSlabs ? slabs.alloc(bytes) : bestFit.alloc(bytes);
+        frameSizes[slot] = bytes;
+
+        ++result.allocCount;
+        if (!frames[slot])
+            ++result.failedAllocCount;
+    }
+
+    result.elapsedTicks = timer.elapsed_ticks();
+    result.availableBytes = bestFit.available_bytes();
+    result.largestFreeBlock = task::TaskHeap::getLargestFreeBlock(bestFit);
+
+    for (int slot = 0; slot < CHURN_LIVE_FRAMES; ++slot)
+    {
+        if (!frames[slot])
+            continue;
+
+        if (useSlabs)
+            slabs.free(frames[slot], frameSizes[slot]);
+        else
+            bestFit.free(frames[slot]);
+    }
+
+    return result;
+}
+
+auto runScheduler() -> SchedulerResult
+{
+    SchedulerResult result{};
+    result.taskCount = SCHEDULER_TASK_COUNT;
+
+    // Frames are allocated from a separate arena, as many tasks don't fit in `TaskHeap`
+    task::TaskArena arena(SCHEDULER_ARENA_SIZE);
+    task::TaskManager taskManager(arena);
+
+    int resumeCount = 0;
+    bn::timer timer;
+
+    for (int i = 0; i < SCHEDULER_TASK_COUNT; ++i)
+    {
+        if (i % 2 == 0)
+            taskManager.spawnTask([&resumeCount, i] { return timerWaiter(resumeCount, 1 + i % 4); });
+        else
+            taskManager.spawnTask([&resumeCount, i] { return signalWaiter(resumeCount, i / 2); });
+    }
+
+    result.spawnTicks = timer.elapsed_ticks();
+
+    resumeCount = 0;
+    timer.restart();
+
+    for (int update = 0; update < SCHEDULER_UPDATES; ++update)
+    {
+        for (int key = update % SCHEDULER_SIGNAL_KEY_GROUPS; key < SCHEDULER_TASK_COUNT / 2;
+             key += SCHEDULER_SIGNAL_KEY_GROUPS)
+        {
+            taskManager.postSignal(task::TaskSignal{.kind = task::TaskSignal::Kind::NPC_WALK_END, .key = key});
+        }
+
+        // one frame per update, regardless of the frames missed before the benchmark
+        taskManager.update(1);
+    }
+
+    result.updateTicks = timer.elapsed_ticks();
+    result.updateCount = SCHEDULER_UPDATES;
+    result.resumeCount = resumeCount;
+
+    taskManager.onSignal(task::TaskSignal{.kind = task::TaskSignal::Kind::SCENE_DESTROYED});
+    result.peakHeapBytes = arena.getPeakBytes();
+
+    // frame sizes of the tasks, allocated from the slabs of the global heap
+    auto& heap = task::TaskHeap::instance();
+    void* frames[SCHEDULER_ALLOC_COUNT];
+    constexpr int FRAME_SIZE_COUNT = int(sizeof(CHURN_FRAME_SIZES) / sizeof(int));
+
+    timer.restart();
+    for (int i = 0; i < SCHEDULER_ALLOC_COUNT; ++i)
+        frames[i] = heap.alloc(CHURN_FRAME_SIZES[i % FRAME_SIZE_COUNT]);
+    result.allocTicks = timer.elapsed_ticks();
+
+    timer.restart();
+    for (int i = 0; i < SCHEDULER_ALLOC_COUNT; ++i)
+    {
+        if (frames[i])
+            heap.free(frames[i], CHURN_FRAME_SIZES[i % FRAME_SIZE_COUNT]);
+    }
+    result.freeTicks = timer.elapsed_ticks();
+    result.allocCount = SCHEDULER_ALLOC_COUNT;
+
+    return result;
+}
+
+auto runGenerator() -> GeneratorResult
+{
+    GeneratorResult result{};
+    bn::timer timer;
+
+    int generatorSum = 0;
+    for (int x : spawnPattern())
+    {
+        generatorSum += x;
+        ++result.valueCount;
+    }
+
+    result.generatorTicks = timer.elapsed_ticks();
+    timer.restart();
+
+    int stateMachineSum = 0;
+    SpawnPatternStateMachine stateMachine;
+    while (stateMachine.next())
+        stateMachineSum += stateMachine.value();
+
+    result.stateMachineTicks = timer.elapsed_ticks();
+
+    BN_ASSERT(generatorSum == stateMachineSum, "Pattern mismatch: ", generatorSum, " != ", stateMachineSum);
+
+    return result;
+}
+
+} // namespace bench
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "NpcWalkerSystem.hpp"
+
+#include <bn_algorithm.h>
+#include <bn_assert.h>
+
+namespace
+{
+
+constexpr int ANIM_WAIT_UPDATES = 15;
+
+} // namespace
+
+void NpcWalkerSystem::update(int frames)
+{
+    BN_ASSERT(frames > 0, "Invalid frames: ", frames);
+
+    for (int i = 0; i < _size; ++i)
+    {
+        if (_remainingUpdates[i] == 0)
+            continue;
+
+        // don't walk past the destination, even if more frames are skipped than left
+        const int steps = bn::min(frames, int(_remainingUpdates[i]));
+
+        _remainingUpdates[i] -= steps;
+        _xs[i] += _velocityXs[i] * steps;
+        _sprites[i].set_x(_xs[i]);
+
+        // swap the shared tiles handle only when the animation frame changes
+        if (_animWaitCounters[i] > steps)
+        {
+            _animWaitCounters[i] -= steps;
+        }
+        else
+        {
+            const int overSteps = steps - _animWaitCounters[i];
+
+            _animWaitCounters[i] = ANIM_WAIT_UPDATES - overSteps % ANIM_WAIT_UPDATES;
+            _animFrames[i] = (_animFrames[i] + 1 + overSteps / ANIM_WAIT_UPDATES) & 3;
+
+            const int tilesIdx = ((_directions[i] > 0) ? 5 : 1) + _animFrames[i];
+            _sprites[i].set_tiles(_tiles[tilesIdx]);
+        }
+    }
+}
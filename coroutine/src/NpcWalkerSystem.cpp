@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "NpcWalkerSystem.hpp"
+
+#include <bn_assert.h>
+#include <bn_core.h>
+
+#include "TaskAwaiters.hpp"
+#include "TaskManager.hpp"
+#include "TaskWhen.hpp"
+#include "WalkingNinja.hpp"
+
+#include "bn_sprite_items_ninja.h"
+
+namespace
+{
+
+constexpr const bn::sprite_item& SPR_ITEM = bn::sprite_items::ninja;
+
+constexpr uint16_t STOP_GFX_IDX = 0;
+constexpr uint16_t LEFT_GFX_IDX_BEGIN = 8;
+constexpr uint16_t RIGHT_GFX_IDX_BEGIN = 12;
+
+// same pace as `WalkingNinja`
+constexpr int MOVE_DURATION_UPDATES = 120;
+
+// updates to rest between walks
+constexpr int REST_UPDATES = 30;
+
+} // namespace
+
+NpcWalkerSystem::NpcWalkerSystem(task::TaskManager& taskManager)
+    : _taskManager(taskManager), _decisionTasks(taskManager)
+{
+    // every walker shares these, so that an animation frame only swaps a tiles handle
+    _tiles.push_back(SPR_ITEM.tiles_item().create_tiles(STOP_GFX_IDX));
+    for (int i = 0; i < 4; ++i)
+        _tiles.push_back(SPR_ITEM.tiles_item().create_tiles(LEFT_GFX_IDX_BEGIN + i));
+    for (int i = 0; i < 4; ++i)
+        _tiles.push_back(SPR_ITEM.tiles_item().create_tiles(RIGHT_GFX_IDX_BEGIN + i));
+}
+
+int NpcWalkerSystem::addWalker(const bn::fixed_point& initPos)
+{
+    BN_ASSERT(_size < MAX_WALKERS, "Too many walkers: ", _size);
+
+    const int walkerId = _size++;
+    const bn::fixed x = bn::clamp(initPos.x(), WalkingNinja::LEFT_MOST_X, WalkingNinja::RIGHT_MOST_X);
+
+    _xs[walkerId] = x;
+    _velocityXs[walkerId] = 0;
+    _prevXs[walkerId] = x;
+    _remainingUpdates[walkerId] = 0;
+    _directions[walkerId] = 0;
+    _animWaitCounters[walkerId] = 0;
+    _animFrames[walkerId] = 0;
+
+    _sprites.push_back(SPR_ITEM.create_sprite(x, initPos.y(), STOP_GFX_IDX));
+
+    _decisionTasks.addTask(decide(walkerId));
+    return walkerId;
+}
+
+void NpcWalkerSystem::stopWalker(int walkerId)
+{
+    BN_ASSERT(0 <= walkerId && walkerId < _size, "Invalid walkerId: ", walkerId);
+
+    _taskManager.onSignal(task::TaskSignal{
+        .kind = task::TaskSignal::Kind::NPC_WALK_END,
+        .key = walkerId,
+        .payload = {.npcWalkEnd = {.movedDistance = _xs[walkerId] - _prevXs[walkerId]}},
+    });
+}
+
+void NpcWalkerSystem::update()
+{
+    update(1 + bn::core::last_missed_frames());
+}
+
+int NpcWalkerSystem::size() const
+{
+    return _size;
+}
+
+auto NpcWalkerSystem::decide(int walkerId) -> task::Task
+{
+    while (true)
+    {
+        startWalk(walkerId);
+
+        // `update()` stops the walker by itself on arrival, so the timer only tells when it's arrived.
+        task::TimeAwaiter arriveAwaiter(MOVE_DURATION_UPDATES);
+        task::NpcWalkEndAwaiter stopAwaiter(walkerId);
+        const int winner = co_await task::whenAny(arriveAwaiter, stopAwaiter);
+
+        endWalk(walkerId, winner == 0);
+
+        co_await task::TimeAwaiter(REST_UPDATES);
+    }
+}
+
+void NpcWalkerSystem::startWalk(int walkerId)
+{
+    const int8_t direction = (_directions[walkerId] > 0) ? -1 : +1;
+    const bn::fixed destinationX = (direction > 0) ? WalkingNinja::RIGHT_MOST_X : WalkingNinja::LEFT_MOST_X;
+
+    _prevXs[walkerId] = _xs[walkerId];
+    _velocityXs[walkerId] = (destinationX - _xs[walkerId]) / MOVE_DURATION_UPDATES;
+    _remainingUpdates[walkerId] = MOVE_DURATION_UPDATES;
+    _directions[walkerId] = direction;
+
+    // show the first animation frame on the first update
+    _animWaitCounters[walkerId] = 1;
+    _animFrames[walkerId] = 3;
+}
+
+void NpcWalkerSystem::endWalk(int walkerId, bool arrived)
+{
+    // snap to the destination, as the velocity is rounded and some updates might be skipped
+    if (arrived)
+        _xs[walkerId] = (_directions[walkerId] > 0) ? WalkingNinja::RIGHT_MOST_X : WalkingNinja::LEFT_MOST_X;
+
+    _remainingUpdates[walkerId] = 0;
+
+    bn::sprite_ptr& sprite = _sprites[walkerId];
+    sprite.set_x(_xs[walkerId]);
+    sprite.set_tiles(_tiles[0]);
+}
@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "NumericLabel.hpp"
+
+#include <bn_optional.h>
+#include <bn_sprite_palette_ptr.h>
+#include <bn_sprite_tiles_ptr.h>
+#include <bn_string.h>
+
+namespace
+{
+
+constexpr bn::string_view GLYPHS = "0123456789-.";
+
+/// @brief Glyph tiles & palette shared by every `NumericLabel`, which stay in VRAM once created.
+class GlyphCache
+{
+public:
+    explicit GlyphCache(const bn::sprite_font& font)
+        : _font(font), _palette(font.item().palette_item().create_palette())
+    {
+        BN_ASSERT(font.item().shape_size().width() == 8, "Font glyph must be 8 pixels wide");
+
+        // glyphs of sprite font start from ' '
+        for (char ch : GLYPHS)
+            _tiles.push_back(font.item().tiles_item().create_tiles(ch - ' '));
+    }
+
+public:
+    auto getFont() const -> const bn::sprite_font&
+    {
+        return _font;
+    }
+
+    auto getPalette() const -> const bn::sprite_palette_ptr&
+    {
+        return _palette;
+    }
+
+    auto getTiles(char ch) const -> const bn::sprite_tiles_ptr&
+    {
+        for (int glyphIdx = 0; glyphIdx < GLYPHS.size(); ++glyphIdx)
+            if (GLYPHS[glyphIdx] == ch)
+                return _tiles[glyphIdx];
+
+        BN_ERROR("Not a numeric glyph: ", ch);
+        return _tiles[0];
+    }
+
+    int getWidth(char ch) const
+    {
+        const auto widths = _font.character_widths_ref();
+        const int charIdx = ch - ' ';
+
+        // fixed width font doesn't have the widths
+        return (charIdx < widths.size()) ? widths[charIdx] : 8;
+    }
+
+private:
+    const bn::sprite_font& _font;
+    bn::sprite_palette_ptr _palette;
+    bn::vector<bn::sprite_tiles_ptr, GLYPHS.size()> _tiles;
+};
+
+auto getGlyphCache(const bn::sprite_font& font) -> const GlyphCache&
+{
+    // created on the first use, as VRAM can't be allocated before `bn::core::init()`
+    static bn::optional<GlyphCache> glyphCache;
+
+    if (!glyphCache)
+        glyphCache.emplace(font);
+
+    BN_ASSERT(&glyphCache->getFont() == &font, "Only one font is cached");
+
+    return *glyphCache;
+}
+
+} // namespace
+
+NumericLabel::NumericLabel(const bn::sprite_font& font, const bn::fixed_point& center) : _font(font), _center(center)
+{
+    // the glyph cache is created up front, so that the first value doesn't upload the tiles
+    getGlyphCache(font);
+}
+
+void NumericLabel::setValue(bn::fixed value)
+{
+    const auto& glyphCache = getGlyphCache(_font);
+    const auto text = bn::to_string<MAX_GLYPHS>(value);
+
+    _charCount = text.size();
+
+    // destroy the sprites of the glyphs not used anymore
+    while (_sprites.size() > _charCount)
+        _sprites.pop_back();
+
+    for (int i = 0; i < _charCount; ++i)
+    {
+        const char ch = text[i];
+
+        if (i >= _sprites.size())
+        {
+            auto sprite = bn::sprite_ptr::create(_center, _font.item().shape_size(), glyphCache.getTiles(ch),
+                                                 glyphCache.getPalette());
+            sprite.set_bg_priority(_bgPriority);
+            _sprites.push_back(bn::move(sprite));
+        }
+        // swap the tiles of the changed glyphs only
+        else if (ch != _chars[i])
+        {
+            _sprites[i].set_tiles(glyphCache.getTiles(ch));
+        }
+
+        _chars[i] = ch;
+    }
+
+    layout();
+}
+
+void NumericLabel::setPosition(const bn::fixed_point& center)
+{
+    _center = center;
+    layout();
+}
+
+void NumericLabel::setVisible(bool visible)
+{
+    _visible = visible;
+    layout();
+}
+
+void NumericLabel::setBgPriority(int bgPriority)
+{
+    _bgPriority = bgPriority;
+
+    for (auto& sprite : _sprites)
+        sprite.set_bg_priority(bgPriority);
+}
+
+auto NumericLabel::sprites() const -> const bn::ivector<bn::sprite_ptr>&
+{
+    return _sprites;
+}
+
+int NumericLabel::glyphCount() const
+{
+    return _charCount;
+}
+
+void NumericLabel::layout()
+{
+    const auto& glyphCache = getGlyphCache(_font);
+
+    int width = 0;
+    for (int i = 0; i < _charCount; ++i)
+        width += glyphCache.getWidth(_chars[i]);
+
+    // sprite position is its center, and each glyph is drawn from the left of its sprite
+    bn::fixed x = _center.x() - width / 2 + 4;
+
+    for (int i = 0; i < _charCount; ++i)
+    {
+        auto& sprite = _sprites[i];
+
+        sprite.set_position(x, _center.y());
+        sprite.set_visible(_visible);
+        x += glyphCache.getWidth(_chars[i]);
+    }
+}
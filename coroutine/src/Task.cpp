@@ -3,28 +3,74 @@
 
 #include "Task.hpp"
 
+#include <utility>
+
 #include <bn_assert.h>
 
 #include "TaskHeap.hpp"
+#include "TaskTrace.hpp"
+#include "TaskWaitNode.hpp"
 
 namespace task
 {
 
 auto Task::promise_type::get_return_object() -> Task
 {
+#ifdef TASK_TRACE_ENABLED
+    traceId = int16_t(TaskTrace::instance().newTaskId());
+#endif
+    TASK_TRACE(CREATE, traceId);
+
     return Task(CoHandle::from_promise(*this));
 }
 
-auto Task::promise_type::initial_suspend() -> std::suspend_never
+auto Task::promise_type::initial_suspend() -> std::suspend_always
 {
+    // Lazily started by `TaskManager::addTask()`, so that awaiters can find the `TaskManager` to register into.
     return {};
 }
 
-auto Task::promise_type::final_suspend() noexcept -> std::suspend_always
+auto Task::promise_type::final_suspend() noexcept -> FinalAwaiter
 {
     return {};
 }
 
+bool Task::promise_type::FinalAwaiter::await_ready() noexcept
+{
+    return false;
+}
+
+auto Task::promise_type::FinalAwaiter::await_suspend(CoHandle coHandle) noexcept -> std::coroutine_handle<>
+{
+    auto& promise = coHandle.promise();
+    TASK_TRACE(COMPLETE, promise.traceId);
+
+    // A child task resumes its parent, and its frame is destroyed later by the `Task` of the parent.
+    if (promise.continuation)
+        return promise.continuation;
+
+    // A child task of a wait group resumes its parent only if the group is done.
+    if (promise.waitNode)
+    {
+        auto& node = *promise.waitNode;
+        if (!node.group || node.group->onWaitNodeReady(node))
+            return node.coHandle;
+
+        return std::noop_coroutine();
+    }
+
+    // A task owned by `TaskManager` is linked in its task list.
+    // Destroying the frame unlinks it in O(1), so that the finished tasks don't need to be swept.
+    if (promise.isLinked())
+        coHandle.destroy();
+
+    return std::noop_coroutine();
+}
+
+void Task::promise_type::FinalAwaiter::await_resume() noexcept
+{
+}
+
 void Task::promise_type::unhandled_exception()
 {
     BN_ERROR("Task::promise_type has an unhandled exception");
@@ -34,21 +80,20 @@ void Task::promise_type::return_void()
 {
 }
 
-void* Task::promise_type::operator new(unsigned bytes) noexcept
+void* Task::promise_type::operator new(std::size_t bytes) noexcept
 {
-    auto& allocator = TaskHeap::instance().getAllocator();
+    auto& heap = TaskHeap::instance();
 
-    void* ptr = allocator.alloc(int(bytes));
-    BN_ASSERT(ptr, "Task alloc failed: req=", bytes, ", free=", allocator.available_bytes());
+    void* ptr = heap.alloc(int(bytes));
+    BN_ASSERT(ptr, "Task alloc failed: req=", bytes, ", free=", heap.getAllocator().available_bytes());
 
     return ptr;
 }
 
-void Task::promise_type::operator delete(void* ptr) noexcept
+void Task::promise_type::operator delete(void* ptr, std::size_t bytes) noexcept
 {
-    auto& allocator = TaskHeap::instance().getAllocator();
-
-    allocator.free(ptr);
+    // sized deallocation, so that the size class of the frame is known in O(1)
+    TaskHeap::instance().free(ptr, int(bytes));
 }
 
 auto Task::promise_type::get_return_object_on_allocation_failure() -> Task
@@ -74,6 +119,9 @@ Task::Task(Task&& other) noexcept : _coHandle(std::move(other._coHandle))
 
 Task& Task::operator=(Task&& other) noexcept
 {
+    if (_coHandle)
+        _coHandle.destroy();
+
     _coHandle = std::move(other._coHandle);
     other._coHandle = nullptr;
     return *this;
@@ -86,13 +134,62 @@ bool Task::done() const
 
 void Task::resume()
 {
-    if (_coHandle && !_coHandle.done())
-        _coHandle.resume();
+    if (!_coHandle || _coHandle.done())
+        return;
+
+#ifdef TASK_TRACE_ENABLED
+    const int traceId = _coHandle.promise().traceId;
+#endif
+    TASK_TRACE(RESUME_BEGIN, traceId);
+
+    _coHandle.resume();
+
+    TASK_TRACE(RESUME_END, traceId);
+}
+
+auto Task::getCoHandle() const -> CoHandle
+{
+    return _coHandle;
+}
+
+auto Task::release() -> CoHandle
+{
+    const auto coHandle = _coHandle;
+    _coHandle = nullptr;
+    return coHandle;
+}
+
+auto Task::operator co_await() const noexcept -> Awaiter
+{
+    return Awaiter(_coHandle);
+}
+
+Task::Awaiter::Awaiter(CoHandle child) : _child(child)
+{
+    BN_ASSERT(child, "Invalid task");
+    BN_ASSERT(!child.promise().isLinked(), "Task is already added to `TaskManager`");
+}
+
+bool Task::Awaiter::await_ready() const noexcept
+{
+    return _child.done();
+}
+
+auto Task::Awaiter::await_suspend(CoHandle parent) noexcept -> std::coroutine_handle<>
+{
+    auto& parentPromise = parent.promise();
+    auto& childPromise = _child.promise();
+
+    // Awaiters in the child register to the `TaskManager` of the parent, with the same priority
+    childPromise.taskManager = parentPromise.taskManager;
+    childPromise.priority = parentPromise.priority;
+    childPromise.continuation = parent;
+
+    return _child;
 }
 
-auto Task::getTaskSignal() -> TaskSignal&
+void Task::Awaiter::await_resume() noexcept
 {
-    return _coHandle.promise().taskSignal;
 }
 
 } // namespace task
@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "TaskArena.hpp"
+
+#include <bn_algorithm.h>
+#include <bn_assert.h>
+#include <bn_log.h>
+#include <bn_memory.h>
+
+#include "TaskHeap.hpp"
+
+namespace task
+{
+
+TaskArena::TaskArena(int bytes)
+    : _mem(static_cast<uint8_t*>(bn::memory::ewram_alloc(bytes))), _maxBytes(bytes), _usedBytes(0)
+{
+    BN_ASSERT(_mem, "TaskArena alloc failed: ", bytes);
+
+    TaskHeap::instance().addArena(*this);
+}
+
+TaskArena::~TaskArena()
+{
+    // frames should be already destroyed by `TaskManager`, which is bound to this
+    BN_ASSERT(_liveCount == 0, "Frames alive in TaskArena: ", _liveCount);
+    BN_ASSERT(TaskHeap::instance().getArena() != this, "TaskArena is still bound");
+
+    unlink();
+
+    bn::memory::ewram_free(_mem);
+}
+
+auto TaskArena::alloc(int bytes) -> void*
+{
+    const int alignedBytes = (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    // Frames are usually of a few coroutine functions, so the freed one of the same size is likely found.
+    for (int* link = &_freeBlockOffset; *link != NO_BLOCK;)
+    {
+        auto* block = reinterpret_cast<FreeBlock*>(_mem + *link);
+        if (block->bytes == alignedBytes)
+        {
+            *link = block->nextOffset;
+            ++_liveCount;
+            return block;
+        }
+
+        link = &block->nextOffset;
+    }
+
+    if (alignedBytes > _maxBytes - _usedBytes)
+    {
+        if (_overflowCount++ == 0)
+            BN_LOG("TaskArena is full, falls back to TaskHeap: used=", _usedBytes, ", req=", bytes);
+
+        return nullptr;
+    }
+
+    void* ptr = _mem + _usedBytes;
+    _usedBytes += alignedBytes;
+    _peakBytes = bn::max(_peakBytes, _usedBytes);
+    ++_liveCount;
+    return ptr;
+}
+
+void TaskArena::free(void* ptr, int bytes)
+{
+    --_liveCount;
+
+    if (_isResetting)
+        return;
+
+    const int alignedBytes = (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    if (static_cast<uint8_t*>(ptr) + alignedBytes == _mem + _usedBytes)
+    {
+        _usedBytes -= alignedBytes;
+        return;
+    }
+
+    auto* block = static_cast<FreeBlock*>(ptr);
+    block->nextOffset = _freeBlockOffset;
+    block->bytes = alignedBytes;
+    _freeBlockOffset = int(static_cast<uint8_t*>(ptr) - _mem);
+}
+
+void TaskArena::beginReset()
+{
+    _isResetting = true;
+}
+
+void TaskArena::reset()
+{
+    // A frame still alive here is not owned by the `TaskManager` bound to this, which would dangle.
+    BN_ASSERT(_liveCount == 0, "Frames alive in TaskArena on reset: ", _liveCount);
+
+    _usedBytes = 0;
+    _freeBlockOffset = NO_BLOCK;
+    _isResetting = false;
+}
+
+bool TaskArena::contains(const void* ptr) const
+{
+    const auto* bytePtr = static_cast<const uint8_t*>(ptr);
+    return _mem <= bytePtr && bytePtr < _mem + _maxBytes;
+}
+
+int TaskArena::getUsedBytes() const
+{
+    return _usedBytes;
+}
+
+int TaskArena::getMaxBytes() const
+{
+    return _maxBytes;
+}
+
+int TaskArena::getPeakBytes() const
+{
+    return _peakBytes;
+}
+
+int TaskArena::getLiveCount() const
+{
+    return _liveCount;
+}
+
+int TaskArena::getOverflowCount() const
+{
+    return _overflowCount;
+}
+
+} // namespace task
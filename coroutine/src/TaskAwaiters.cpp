@@ -3,16 +3,39 @@
 
 #include "TaskAwaiters.hpp"
 
+#include <bn_algorithm.h>
 #include <bn_assert.h>
+#include <bn_timer.h>
+
+#include "TaskManager.hpp"
 
 namespace task
 {
 
-SignalAwaiter::SignalAwaiter(const task::TaskSignal& signal) : _signal(signal)
+WaitNode::~WaitNode()
+{
+    unpark();
+}
+
+void WaitNode::unpark()
+{
+    if (isReady)
+    {
+        isReady = false;
+        coHandle.promise().taskManager->dropReadyNode();
+    }
+
+    unlink();
+}
+
+SignalAwaiter::SignalAwaiter(const task::TaskSignal& signal)
 {
     BN_ASSERT(signal.kind != task::TaskSignal::Kind::TIME, "`TIME` signal must use `TimeAwaiter` instead");
     BN_ASSERT(signal.kind != task::TaskSignal::Kind::NPC_WALK_END,
               "`NPC_WALK_END` signal must use `DialogChoiceAwaiter` instead");
+
+    _node.kind = signal.kind;
+    _node.key = signal.key;
 }
 
 bool SignalAwaiter::await_ready() const
@@ -22,36 +45,81 @@ bool SignalAwaiter::await_ready() const
 
 void SignalAwaiter::await_suspend(task::Task::CoHandle coHandle)
 {
-    coHandle.promise().taskSignal = _signal;
+    auto& promise = coHandle.promise();
+    BN_ASSERT(promise.taskManager, "Task is not added to `TaskManager`");
+
+    _node.coHandle = coHandle;
+    promise.taskManager->addSignalWaiter(_node);
 }
 
 void SignalAwaiter::await_resume()
 {
 }
 
-TimeAwaiter::TimeAwaiter(int ticks) : _ticks(ticks)
+auto SignalAwaiter::getWaitNode() -> task::WaitNode&
+{
+    return _node;
+}
+
+TimeAwaiter::TimeAwaiter(int frames) : TimeAwaiter(uint32_t(bn::max(frames, 0)), false)
+{
+}
+
+TimeAwaiter::TimeAwaiter(uint32_t frameOrFrames, bool isAbsolute) : _deadline(frameOrFrames), _isAbsolute(isAbsolute)
 {
 }
 
+auto TimeAwaiter::untilFrame(uint32_t frame) -> TimeAwaiter
+{
+    return TimeAwaiter(frame, true);
+}
+
+auto TimeAwaiter::untilTicks(int64_t ticks) -> TimeAwaiter
+{
+    constexpr int64_t TICKS_PER_FRAME = bn::timers::ticks_per_frame();
+
+    // the first frame starting at or after `ticks`
+    return TimeAwaiter(uint32_t((ticks + TICKS_PER_FRAME - 1) / TICKS_PER_FRAME), true);
+}
+
 bool TimeAwaiter::await_ready() const
 {
-    return _ticks <= 0;
+    // The absolute deadline is compared on suspend, as `TaskManager` is not known yet.
+    return !_isAbsolute && _deadline == 0;
 }
 
-void TimeAwaiter::await_suspend(task::Task::CoHandle coHandle)
+bool TimeAwaiter::await_suspend(task::Task::CoHandle coHandle)
 {
-    auto& signal = coHandle.promise().taskSignal;
+    auto& promise = coHandle.promise();
+    BN_ASSERT(promise.taskManager, "Task is not added to `TaskManager`");
+
+    auto& taskManager = *promise.taskManager;
+    const uint32_t now = taskManager.getFrame();
 
-    signal.kind = TaskSignal::Kind::TIME;
-    signal.argument = _ticks;
+    _timer.deadline = _isAbsolute ? _deadline : now + _deadline;
+
+    // Don't suspend if the deadline already passed
+    if (int32_t(_timer.deadline - now) <= 0)
+        return false;
+
+    _timer.coHandle = coHandle;
+    taskManager.addTimer(_timer);
+    return true;
 }
 
 void TimeAwaiter::await_resume()
 {
 }
 
-NpcWalkEndAwaiter::NpcWalkEndAwaiter(int npcId) : _npcId(npcId)
+auto TimeAwaiter::getWaitNode() -> task::WaitNode&
+{
+    return _timer;
+}
+
+NpcWalkEndAwaiter::NpcWalkEndAwaiter(int npcId)
 {
+    _node.kind = TaskSignal::Kind::NPC_WALK_END;
+    _node.key = npcId;
 }
 
 bool NpcWalkEndAwaiter::await_ready() const
@@ -61,18 +129,22 @@ bool NpcWalkEndAwaiter::await_ready() const
 
 void NpcWalkEndAwaiter::await_suspend(task::Task::CoHandle coHandle)
 {
-    _coHandle = coHandle;
+    auto& promise = coHandle.promise();
+    BN_ASSERT(promise.taskManager, "Task is not added to `TaskManager`");
 
-    auto& signal = coHandle.promise().taskSignal;
-    signal.kind = TaskSignal::Kind::NPC_WALK_END;
-    signal.argument = _npcId;
+    // Park in the wait queue of this NPC id
+    _node.coHandle = coHandle;
+    promise.taskManager->addSignalWaiter(_node);
 }
 
 auto NpcWalkEndAwaiter::await_resume() -> bn::fixed
 {
-    auto& result = _coHandle.promise().taskSignal.result;
-    BN_ASSERT(result.type() == bn::type_id<bn::fixed>());
-    return result.value<bn::fixed>();
+    return _node.payload.npcWalkEnd.movedDistance;
+}
+
+auto NpcWalkEndAwaiter::getWaitNode() -> task::WaitNode&
+{
+    return _node;
 }
 
 } // namespace task
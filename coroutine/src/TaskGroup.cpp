@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "TaskGroup.hpp"
+
+#include <utility>
+
+#include "TaskManager.hpp"
+
+namespace task
+{
+
+CancellationToken::CancellationToken(TaskGroup& group, uint16_t generation) : _group(&group), _generation(generation)
+{
+}
+
+bool CancellationToken::isCancelled() const
+{
+    return _group && _group->_generation != _generation;
+}
+
+void CancellationToken::cancel()
+{
+    if (_group && !isCancelled())
+        _group->cancel();
+}
+
+TaskGroup::TaskGroup(TaskManager& taskManager) : _taskManager(taskManager)
+{
+    _taskManager.addGroup(*this);
+}
+
+TaskGroup::~TaskGroup()
+{
+    cancel();
+}
+
+void TaskGroup::addTask(task::Task&& task, task::TaskPriority priority)
+{
+    _taskManager.startTask(std::move(task), priority, _tasks);
+}
+
+void TaskGroup::cancel()
+{
+    ++_generation;
+
+    // Destroying a frame unlinks its promise from the list.
+    while (!_tasks.empty())
+        task::Task::CoHandle::from_promise(_tasks.front()).destroy();
+}
+
+auto TaskGroup::getToken() -> CancellationToken
+{
+    return CancellationToken(*this, _generation);
+}
+
+bool TaskGroup::empty() const
+{
+    return _tasks.empty();
+}
+
+} // namespace task
@@ -3,6 +3,10 @@
 
 #include "TaskHeap.hpp"
 
+#include <bn_algorithm.h>
+#include <bn_assert.h>
+#include <bn_log.h>
+
 namespace task
 {
 
@@ -12,10 +16,81 @@ auto TaskHeap::instance() -> TaskHeap&
     return taskHeap;
 }
 
-TaskHeap::TaskHeap() : _alloc(_mem, sizeof(_mem))
+TaskHeap::TaskHeap() : _alloc(_mem, sizeof(_mem)), _slabAlloc(_alloc)
 {
 }
 
+auto TaskHeap::alloc(int bytes) -> void*
+{
+    void* ptr = nullptr;
+
+    if (_curArena)
+        ptr = _curArena->alloc(bytes);
+
+    if (!ptr)
+        ptr = _slabAlloc.alloc(bytes);
+
+    if (ptr)
+        countAlloc(bytes);
+    else
+        ++_failedAllocCount;
+
+    return ptr;
+}
+
+void TaskHeap::free(void* ptr, int bytes)
+{
+    countFree(bytes);
+
+    // Frames are freed mostly while their `TaskManager` is resumed, with its arena bound.
+    if (_curArena && _curArena->contains(ptr))
+    {
+        _curArena->free(ptr, bytes);
+        return;
+    }
+
+    const auto* bytePtr = static_cast<const uint8_t*>(ptr);
+    if (_mem <= bytePtr && bytePtr < _mem + sizeof(_mem))
+    {
+        _slabAlloc.free(ptr, bytes);
+        return;
+    }
+
+    // There are only a few arenas alive at once, usually one per scene.
+    for (auto& arena : _arenas)
+    {
+        if (arena.contains(ptr))
+        {
+            arena.free(ptr, bytes);
+            return;
+        }
+    }
+
+    BN_ERROR("Frame is not allocated from TaskHeap");
+}
+
+auto TaskHeap::getArena() const -> TaskArena*
+{
+    return _curArena;
+}
+
+TaskHeap::ArenaScope::ArenaScope(TaskArena* arena) : _prevArena(TaskHeap::instance()._curArena)
+{
+    BN_ASSERT(!arena || arena->isLinked(), "Arena is not registered");
+
+    TaskHeap::instance()._curArena = arena;
+}
+
+TaskHeap::ArenaScope::~ArenaScope()
+{
+    TaskHeap::instance()._curArena = _prevArena;
+}
+
+void TaskHeap::addArena(TaskArena& arena)
+{
+    _arenas.pushBack(arena);
+}
+
 auto TaskHeap::getAllocator() -> bn::best_fit_allocator&
 {
     return _alloc;
@@ -26,4 +101,108 @@ auto TaskHeap::getAllocator() const -> const bn::best_fit_allocator&
     return _alloc;
 }
 
+int TaskHeap::getUsedBytes() const
+{
+    return _usedBytes;
+}
+
+int TaskHeap::getPeakBytes() const
+{
+    return _peakBytes;
+}
+
+int TaskHeap::getAllocCount() const
+{
+    return _allocCount;
+}
+
+int TaskHeap::getFailedAllocCount() const
+{
+    return _failedAllocCount;
+}
+
+auto TaskHeap::getFrameSizeCounts() const -> bn::span<const FrameSizeCount>
+{
+    return bn::span<const FrameSizeCount>(_frameSizeCounts, _frameSizeCountsSize);
+}
+
+int TaskHeap::getLargestFreeBlock()
+{
+    return getLargestFreeBlock(_alloc);
+}
+
+int TaskHeap::getLargestFreeBlock(bn::best_fit_allocator& allocator)
+{
+    int lo = 0;
+    int hi = allocator.available_bytes();
+
+    while (lo < hi)
+    {
+        const int mid = (lo + hi + 1) / 2;
+
+        if (void* ptr = allocator.alloc(mid))
+        {
+            allocator.free(ptr);
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+
+    return lo;
+}
+
+void TaskHeap::logStats()
+{
+    BN_LOG("TaskHeap: used=", _usedBytes, ", peak=", _peakBytes, ", allocs=", _allocCount,
+           ", failed=", _failedAllocCount);
+    BN_LOG("TaskHeap: largest free=", getLargestFreeBlock(), ", free=", _alloc.available_bytes());
+
+    for (const auto& frameSize : getFrameSizeCounts())
+        BN_LOG("  ", frameSize.bytes, "B: allocs=", frameSize.allocCount, ", live=", frameSize.liveCount);
+
+    for (const auto& arena : _arenas)
+        BN_LOG("  arena: used=", arena.getUsedBytes(), "/", arena.getMaxBytes(), ", live=", arena.getLiveCount(),
+               ", overflow=", arena.getOverflowCount());
+}
+
+void TaskHeap::countAlloc(int bytes)
+{
+    _usedBytes += bytes;
+    _peakBytes = bn::max(_peakBytes, _usedBytes);
+    ++_allocCount;
+
+    // There are only a few coroutine functions, so a linear search is enough.
+    for (int i = 0; i < _frameSizeCountsSize; ++i)
+    {
+        auto& frameSize = _frameSizeCounts[i];
+        if (frameSize.bytes == bytes)
+        {
+            ++frameSize.allocCount;
+            ++frameSize.liveCount;
+            return;
+        }
+    }
+
+    if (_frameSizeCountsSize < MAX_FRAME_SIZES)
+        _frameSizeCounts[_frameSizeCountsSize++] = FrameSizeCount{bytes, 1, 1};
+}
+
+void TaskHeap::countFree(int bytes)
+{
+    _usedBytes -= bytes;
+
+    for (int i = 0; i < _frameSizeCountsSize; ++i)
+    {
+        auto& frameSize = _frameSizeCounts[i];
+        if (frameSize.bytes == bytes)
+        {
+            --frameSize.liveCount;
+            return;
+        }
+    }
+}
+
 } // namespace task
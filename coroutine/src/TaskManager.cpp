@@ -3,88 +3,358 @@
 
 #include "TaskManager.hpp"
 
+#include <utility>
+
+#include <bn_algorithm.h>
+#include <bn_core.h>
+
+#include "TaskGroup.hpp"
+#include "TaskHeap.hpp"
 #include "TaskSignal.hpp"
+#include "TaskTrace.hpp"
 
 namespace task
 {
 
+TaskManager::TaskManager() : _arena(nullptr)
+{
+}
+
+TaskManager::TaskManager(task::TaskArena& arena) : _arena(&arena)
+{
+}
+
+TaskManager::~TaskManager()
+{
+    // destroy frames before the arena is destroyed
+    cancelAllTasks();
+}
+
 void TaskManager::update()
 {
-    auto beforeIt = _tasks.before_begin();
-    auto it = _tasks.begin();
+    update(1 + bn::core::last_missed_frames());
+}
 
-    while (it != _tasks.end())
-    {
-        if (it->done())
-        {
-            it = _tasks.erase_after(beforeIt);
-        }
-        else
-        {
-            auto& signal = it->getTaskSignal();
+void TaskManager::update(int frames)
+{
+    BN_ASSERT(frames > 0, "Invalid frames: ", frames);
 
-            // Resume coroutine that awaits `TimeAwaiter` when there's no remaining ticks to wait
-            if (signal.kind == task::TaskSignal::Kind::TIME)
-            {
-                BN_ASSERT(signal.argument.type() == bn::type_id<int>());
+    TASK_TRACE(UPDATE_BEGIN, 0);
 
-                if (--signal.argument.value<int>() <= 0)
-                    it->resume();
-            }
+    _updateTimer.restart();
 
-            beforeIt = it;
-            ++it;
-        }
+    dispatchPendingSignals();
+
+    // Queue coroutines that await `TimeAwaiter` when their deadline is reached
+    task::IntrusiveList<task::TimerNode> expiredTimers;
+    _timerWheel.advanceTo(_timerWheel.now() + frames, expiredTimers);
+
+    while (!expiredTimers.empty())
+    {
+        auto& timer = expiredTimers.popFront();
+        pushReadyNode(timer);
     }
+
+    updateActions(frames);
+
+    resumeReadyTasks();
+
+    TASK_TRACE(UPDATE_END, 0);
 }
 
-void TaskManager::addTask(task::Task&& task)
+void TaskManager::addTask(task::Task&& task, task::TaskPriority priority)
 {
-    _tasks.push_front(std::move(task));
+    startTask(std::move(task), priority, _tasks);
 }
 
 void TaskManager::onSignal(const task::TaskSignal& received)
 {
     using SigKind = task::TaskSignal::Kind;
 
+    TASK_TRACE_SIGNAL(received);
+
+    // The pending signal of the same key is superseded by this one,
+    // so that it doesn't resume a task which started awaiting after this.
+    _pendingSignals.remove(received.kind, received.key);
+
     // All tasks are cancelled when scene is destroyed
     if (received.kind == SigKind::SCENE_DESTROYED)
     {
-        _tasks.clear();
+        cancelAllTasks();
+        return;
     }
-    else
+
+    BN_ASSERT(received.kind != SigKind::TIME, "`TIME` signal is handled by `TimeAwaiter`");
+
+    // Take the waiters out first, so that a task awaiting the same signal again is not resumed twice.
+    task::IntrusiveList<task::SignalNode> matched;
+    _signalTable.take(received.kind, received.key, matched);
+
+    while (!matched.empty())
     {
-        for (auto& task : _tasks)
+        auto& node = matched.popFront();
+
+        // Pass the payload of the signal to the awaiter. (e.g. the moved distance of NPC)
+        // It will be a return value of `co_await NPCWalkEndAwaiter(..)`
+        node.payload = received.payload;
+
+        resumeWaiter(node);
+    }
+}
+
+void TaskManager::postSignal(const task::TaskSignal& signal)
+{
+    BN_ASSERT(signal.kind != task::TaskSignal::Kind::TIME, "`TIME` signal is handled by `TimeAwaiter`");
+
+    _pendingSignals.push(signal);
+}
+
+auto TaskManager::getFrame() const -> uint32_t
+{
+    return _timerWheel.now();
+}
+
+auto TaskManager::getTicks() const -> int64_t
+{
+    constexpr int TICKS_PER_FRAME = bn::timers::ticks_per_frame();
+
+    const int subFrameTicks = bn::min(_updateTimer.elapsed_ticks(), TICKS_PER_FRAME - 1);
+    return int64_t(getFrame()) * TICKS_PER_FRAME + subFrameTicks;
+}
+
+void TaskManager::addTimer(task::TimerNode& timer)
+{
+    _timerWheel.add(timer);
+}
+
+void TaskManager::addSignalWaiter(task::SignalNode& node)
+{
+    _signalTable.add(node);
+}
+
+void TaskManager::addActionWaiter(task::ActionNode& node)
+{
+    _actionWaiters.pushBack(node);
+}
+
+void TaskManager::setResumeBudget(int resumes)
+{
+    BN_ASSERT(resumes >= 0, "Invalid resumes: ", resumes);
+
+    _resumeBudget = resumes;
+}
+
+void TaskManager::setTickBudget(int ticks)
+{
+    BN_ASSERT(ticks >= 0, "Invalid ticks: ", ticks);
+
+    _tickBudget = ticks;
+}
+
+bool TaskManager::isLinearSignalScanEnabled() const
+{
+    return _signalTable.isLinearScanEnabled();
+}
+
+void TaskManager::setLinearSignalScanEnabled(bool enabled)
+{
+    _signalTable.setLinearScanEnabled(enabled);
+}
+
+int TaskManager::getDeferredResumeCount() const
+{
+    return _deferredResumeCount;
+}
+
+int TaskManager::getTotalDeferredResumeCount() const
+{
+    return _totalDeferredResumeCount;
+}
+
+void TaskManager::resumeTask(task::Task::CoHandle coHandle)
+{
+    if (!coHandle || coHandle.done())
+        return;
+
+#ifdef TASK_TRACE_ENABLED
+    const int traceId = coHandle.promise().traceId;
+#endif
+    TASK_TRACE(RESUME_BEGIN, traceId);
+
+    // Child tasks created by this task are allocated from the arena of this, if any.
+    TaskHeap::ArenaScope arenaScope(_arena);
+
+    // The frame might be destroyed in this call, when the task is finished.
+    coHandle.resume();
+
+    TASK_TRACE(RESUME_END, traceId);
+}
+
+void TaskManager::resumeWaiter(task::WaitNode& node)
+{
+    // A node of a wait group resumes its task only if the group is done
+    if (node.group && !node.group->onWaitNodeReady(node))
+        return;
+
+    resumeTask(node.coHandle);
+}
+
+void TaskManager::dispatchPendingSignals()
+{
+    using SigKind = task::TaskSignal::Kind;
+
+    while (!_pendingSignals.empty())
+    {
+        const task::TaskSignal received = _pendingSignals.pop();
+        TASK_TRACE_SIGNAL(received);
+
+        if (received.kind == SigKind::SCENE_DESTROYED)
         {
-            auto& signal = task.getTaskSignal();
-
-            if (signal.kind != received.kind)
-                continue;
-
-            switch (received.kind)
-            {
-            case SigKind::NPC_WALK_END:
-                // NPC id is stored in `TaskSignal::argument` as int
-                BN_ASSERT(signal.argument.type() == bn::type_id<int>());
-                BN_ASSERT(received.argument.type() == bn::type_id<int>());
-
-                // Resume the task of the same NPC id.
-                if (signal.argument.value<int>() == received.argument.value<int>())
-                {
-                    // Pass the moved distance of NPC.
-                    // It will be a return value of `co_await NPCWalkEndAwaiter(..)`
-                    signal.result = received.result;
-
-                    // Resume the task.
-                    task.resume();
-                }
-                break;
-
-            default:
-                BN_ERROR("Invalid SigKind=", (int)received.kind);
-            }
+            cancelAllTasks();
+            continue;
         }
+
+        task::IntrusiveList<task::SignalNode> matched;
+        _signalTable.take(received.kind, received.key, matched);
+
+        // Waiters are resumed along with the ready timers, in priority order within the budget.
+        while (!matched.empty())
+        {
+            auto& node = matched.popFront();
+            node.payload = received.payload;
+
+            pushReadyNode(node);
+        }
+    }
+}
+
+void TaskManager::startTask(task::Task&& task, task::TaskPriority priority,
+                            task::IntrusiveList<task::Task::promise_type>& owner)
+{
+    const auto coHandle = task.release();
+    BN_ASSERT(coHandle, "Invalid task");
+
+    auto& promise = coHandle.promise();
+    promise.taskManager = this;
+    promise.priority = priority;
+    owner.pushBack(promise);
+
+    resumeTask(coHandle);
+}
+
+void TaskManager::addGroup(task::TaskGroup& group)
+{
+    _groups.pushBack(group);
+}
+
+void TaskManager::destroyAllTasks()
+{
+    // Groups stay registered, only their tasks are cancelled.
+    // They're taken out first, as a group in a destroyed frame unlinks itself.
+    task::IntrusiveList<task::TaskGroup> groups;
+    groups.spliceBack(_groups);
+
+    while (!groups.empty())
+    {
+        auto& group = groups.popFront();
+        _groups.pushBack(group);
+        group.cancel();
     }
+
+    // Destroying a frame unlinks its promise from the list.
+    while (!_tasks.empty())
+        task::Task::CoHandle::from_promise(_tasks.front()).destroy();
+}
+
+void TaskManager::updateActions(int frames)
+{
+    auto it = _actionWaiters.begin();
+
+    while (it != _actionWaiters.end())
+    {
+        auto& node = *it;
+        ++it;
+
+        // Queue the coroutine awaiting the action when it's done, which is resumed in this update
+        if (node.updateAction(frames))
+        {
+            node.unlink();
+            pushReadyNode(node);
+        }
+    }
+}
+
+void TaskManager::cancelAllTasks()
+{
+    if (!_arena)
+    {
+        destroyAllTasks();
+        return;
+    }
+
+    // Frames still have to be destroyed to run the destructors of their locals,
+    // but they're not reclaimed one by one, as the arena is released at once.
+    TaskHeap::ArenaScope arenaScope(_arena);
+    _arena->beginReset();
+
+    destroyAllTasks();
+
+    _arena->reset();
+}
+
+void TaskManager::resumeReadyTasks()
+{
+    bn::timer timer;
+    int resumeCount = 0;
+
+    auto hasBudget = [this, &timer, &resumeCount]() {
+        // At least one task is resumed per update, so that the rolled over tasks are not starved
+        if (resumeCount == 0)
+            return true;
+        if (_resumeBudget > 0 && resumeCount >= _resumeBudget)
+            return false;
+        if (_tickBudget > 0 && timer.elapsed_ticks() >= _tickBudget)
+            return false;
+        return true;
+    };
+
+    // Higher priority first, and FIFO within the same priority
+    for (int priority = PRIORITY_COUNT - 1; priority >= 0 && hasBudget(); --priority)
+    {
+        auto& readyQueue = _readyQueues[priority];
+
+        while (!readyQueue.empty() && hasBudget())
+        {
+            auto& node = popReadyNode(readyQueue);
+            resumeWaiter(node);
+            ++resumeCount;
+        }
+    }
+
+    // Ready nodes left are rolled over
+    _deferredResumeCount = _readyNodeCount;
+    _totalDeferredResumeCount += _deferredResumeCount;
+}
+
+void TaskManager::pushReadyNode(task::WaitNode& node)
+{
+    _readyQueues[int(node.coHandle.promise().priority)].pushBack(node);
+    node.isReady = true;
+    ++_readyNodeCount;
+}
+
+auto TaskManager::popReadyNode(task::IntrusiveList<task::WaitNode>& readyQueue) -> task::WaitNode&
+{
+    auto& node = readyQueue.popFront();
+    node.isReady = false;
+    --_readyNodeCount;
+    return node;
+}
+
+void TaskManager::dropReadyNode()
+{
+    // A ready node is unlinked without being resumed, as its frame is destroyed or its wait group is done.
+    --_readyNodeCount;
 }
 
 } // namespace task
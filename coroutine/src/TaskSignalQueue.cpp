@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "TaskSignalQueue.hpp"
+
+#include <bn_assert.h>
+
+namespace task
+{
+
+static_assert((TaskSignalQueue::CAPACITY & (TaskSignalQueue::CAPACITY - 1)) == 0, "CAPACITY is not power of 2");
+
+bool TaskSignalQueue::empty() const
+{
+    return _count == 0;
+}
+
+bool TaskSignalQueue::full() const
+{
+    return _count == CAPACITY;
+}
+
+void TaskSignalQueue::push(const TaskSignal& signal)
+{
+    for (int i = 0; i < _count; ++i)
+    {
+        auto& pending = at(i);
+        if (pending.kind == signal.kind && pending.key == signal.key)
+        {
+            pending.payload = signal.payload;
+            return;
+        }
+    }
+
+    BN_ASSERT(!full(), "Pending signals full: ", CAPACITY);
+
+    at(_count++) = signal;
+}
+
+auto TaskSignalQueue::pop() -> TaskSignal
+{
+    BN_ASSERT(!empty(), "No pending signal");
+
+    const TaskSignal signal = at(0);
+    _head = (_head + 1) & (CAPACITY - 1);
+    --_count;
+    return signal;
+}
+
+void TaskSignalQueue::remove(TaskSignal::Kind kind, int key)
+{
+    for (int i = 0; i < _count; ++i)
+    {
+        const auto& pending = at(i);
+        if (pending.kind == kind && pending.key == key)
+        {
+            // As signals are coalesced, there's at most one to remove.
+            for (int j = i + 1; j < _count; ++j)
+                at(j - 1) = at(j);
+            --_count;
+            return;
+        }
+    }
+}
+
+auto TaskSignalQueue::at(int index) -> TaskSignal&
+{
+    return _signals[(_head + index) & (CAPACITY - 1)];
+}
+
+} // namespace task
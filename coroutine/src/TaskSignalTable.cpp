@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "TaskSignalTable.hpp"
+
+#include <cstdint>
+
+namespace task
+{
+
+void TaskSignalTable::add(SignalNode& node)
+{
+    getBucket(node.kind, node.key).pushBack(node);
+}
+
+void TaskSignalTable::take(TaskSignal::Kind kind, int key, IntrusiveList<SignalNode>& matched)
+{
+    auto& bucket = getBucket(kind, key);
+
+    auto it = bucket.begin();
+    while (it != bucket.end())
+    {
+        auto& node = *it;
+        ++it;
+
+        // Different keys might share the same bucket
+        if (node.kind == kind && node.key == key)
+        {
+            node.unlink();
+            matched.pushBack(node);
+        }
+    }
+}
+
+bool TaskSignalTable::isLinearScanEnabled() const
+{
+    return _linearScanEnabled;
+}
+
+void TaskSignalTable::setLinearScanEnabled(bool enabled)
+{
+    if (_linearScanEnabled == enabled)
+        return;
+
+    IntrusiveList<SignalNode> nodes;
+    for (auto& bucket : _buckets)
+        nodes.spliceBack(bucket);
+
+    _linearScanEnabled = enabled;
+
+    while (!nodes.empty())
+        add(nodes.popFront());
+}
+
+auto TaskSignalTable::getBucket(TaskSignal::Kind kind, int key) -> IntrusiveList<SignalNode>&
+{
+    // Every signal scans all the nodes, like scanning every task before the keyed wait queues
+    if (_linearScanEnabled)
+        return _buckets[0];
+
+    return _buckets[getBucketIndex(kind, key)];
+}
+
+auto TaskSignalTable::getBucketIndex(TaskSignal::Kind kind, int key) -> int
+{
+    // Fibonacci hashing, so that sequential keys (e.g. NPC ids) are spread evenly.
+    const uint32_t hash = ((uint32_t(key) << 4) ^ uint32_t(kind)) * 2654435769u;
+    return int(hash >> (32 - BUCKET_BITS));
+}
+
+} // namespace task
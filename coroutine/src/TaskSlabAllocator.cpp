@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "TaskSlabAllocator.hpp"
+
+#include <bn_assert.h>
+
+namespace task
+{
+
+TaskSlabAllocator::TaskSlabAllocator(bn::best_fit_allocator& fallback) : _fallback(fallback), _freeLists{}
+{
+}
+
+auto TaskSlabAllocator::alloc(int bytes) -> void*
+{
+    BN_ASSERT(bytes > 0, "Invalid bytes: ", bytes);
+
+    if (bytes > MAX_BLOCK_SIZE)
+        return _fallback.alloc(bytes);
+
+    const int sizeClass = getSizeClass(bytes);
+    FreeBlock*& freeList = _freeLists[sizeClass];
+
+    if (!freeList && !refill(sizeClass))
+        return nullptr;
+
+    FreeBlock* block = freeList;
+    freeList = block->next;
+    return block;
+}
+
+void TaskSlabAllocator::free(void* ptr, int bytes)
+{
+    if (!ptr)
+        return;
+
+    if (bytes > MAX_BLOCK_SIZE)
+    {
+        _fallback.free(ptr);
+        return;
+    }
+
+    FreeBlock*& freeList = _freeLists[getSizeClass(bytes)];
+
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = freeList;
+    freeList = block;
+}
+
+auto TaskSlabAllocator::getSizeClass(int bytes) -> int
+{
+    return (bytes - 1) / BLOCK_ALIGN;
+}
+
+auto TaskSlabAllocator::getBlockSize(int sizeClass) -> int
+{
+    return (sizeClass + 1) * BLOCK_ALIGN;
+}
+
+bool TaskSlabAllocator::refill(int sizeClass)
+{
+    const int blockSize = getBlockSize(sizeClass);
+
+    // If a whole slab doesn't fit, try a single block instead
+    int blockCount = BLOCKS_PER_SLAB;
+    auto* slab = static_cast<uint8_t*>(_fallback.alloc(blockSize * blockCount));
+    if (!slab)
+    {
+        blockCount = 1;
+        slab = static_cast<uint8_t*>(_fallback.alloc(blockSize));
+        if (!slab)
+            return false;
+    }
+
+    FreeBlock*& freeList = _freeLists[sizeClass];
+    for (int i = blockCount - 1; i >= 0; --i)
+    {
+        auto* block = reinterpret_cast<FreeBlock*>(slab + i * blockSize);
+        block->next = freeList;
+        freeList = block;
+    }
+
+    return true;
+}
+
+} // namespace task
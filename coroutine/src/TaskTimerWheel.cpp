@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "TaskTimerWheel.hpp"
+
+#include <bn_assert.h>
+
+namespace task
+{
+
+auto TaskTimerWheel::now() const -> uint32_t
+{
+    return _now;
+}
+
+void TaskTimerWheel::add(TimerNode& timer)
+{
+    BN_ASSERT(int32_t(timer.deadline - _now) > 0, "Deadline already passed: ", timer.deadline, " <= ", _now);
+
+    addTimer(timer);
+}
+
+void TaskTimerWheel::advanceTo(uint32_t frame, IntrusiveList<TimerNode>& expired)
+{
+    BN_ASSERT(int32_t(frame - _now) >= 0, "Can't go back in time: ", frame, " < ", _now);
+
+    while (_now != frame)
+        advance(expired);
+}
+
+void TaskTimerWheel::advance(IntrusiveList<TimerNode>& expired)
+{
+    ++_now;
+
+    // Cascade the upper level slot down, whenever the lower level wraps around
+    for (int level = 1; level < LEVEL_COUNT; ++level)
+    {
+        if ((_now & ((1u << (LEVEL_BITS * level)) - 1)) != 0)
+            break;
+
+        cascade(level);
+    }
+
+    expired.spliceBack(_slots[0][_now & SLOT_MASK]);
+}
+
+void TaskTimerWheel::addTimer(TimerNode& timer)
+{
+    const uint32_t delta = timer.deadline - _now;
+
+    // Timers too far away are put in the last slot, and re-added with the actual deadline when cascaded.
+    const uint32_t slotTime = (delta > MAX_DELTA) ? _now + MAX_DELTA : timer.deadline;
+    const uint32_t slotDelta = slotTime - _now;
+
+    int level = 0;
+    while (level < LEVEL_COUNT - 1 && slotDelta >= (1u << (LEVEL_BITS * (level + 1))))
+        ++level;
+
+    _slots[level][(slotTime >> (LEVEL_BITS * level)) & SLOT_MASK].pushBack(timer);
+}
+
+void TaskTimerWheel::cascade(int level)
+{
+    auto& slot = _slots[level][(_now >> (LEVEL_BITS * level)) & SLOT_MASK];
+
+    while (!slot.empty())
+        addTimer(slot.popFront());
+}
+
+} // namespace task
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
+// SPDX-License-Identifier: 0BSD
+
+#include "TaskTrace.hpp"
+
+#ifdef TASK_TRACE_ENABLED
+
+#include <bn_log.h>
+#include <bn_string_view.h>
+
+namespace task
+{
+
+namespace
+{
+
+auto toMicroseconds(int ticks) -> int
+{
+    return int(int64_t(ticks) * 1'000'000 / bn::timers::ticks_per_second());
+}
+
+} // namespace
+
+auto TaskTrace::instance() -> TaskTrace&
+{
+    // constructed on the first use, as `bn::timer` can't be started before `bn::core::init()`
+    static BN_DATA_EWRAM TaskTrace taskTrace;
+    return taskTrace;
+}
+
+auto TaskTrace::newTaskId() -> int
+{
+    // wraps around, as the id is stored in 16 bits
+    const int id = _nextTaskId;
+    _nextTaskId = (_nextTaskId >= INT16_MAX) ? 1 : _nextTaskId + 1;
+    return id;
+}
+
+void TaskTrace::record(EventType type, int id, TaskSignal::Kind signalKind)
+{
+    // overwrite the oldest event when full
+    Event& event = _events[(_head + _count) % CAPACITY];
+    if (_count < CAPACITY)
+        ++_count;
+    else
+        _head = (_head + 1) % CAPACITY;
+
+    event.ticks = _timer.elapsed_ticks();
+    event.id = int16_t(id);
+    event.type = type;
+    event.signalKind = signalKind;
+}
+
+void TaskTrace::dump()
+{
+    // Each line is logged separately, so `BN_CFG_LOG_MAX_SIZE` should be at least 96.
+    BN_LOG("[");
+
+    for (int i = 0; i < _count; ++i)
+    {
+        const Event& event = _events[(_head + i) % CAPACITY];
+        const int us = toMicroseconds(event.ticks);
+        const bn::string_view comma = (i + 1 < _count) ? "," : "";
+
+        switch (event.type)
+        {
+        case EventType::CREATE:
+            BN_LOG("{\"name\":\"create\",\"ph\":\"i\",\"ts\":", us, ",\"pid\":0,\"tid\":", event.id, "}", comma);
+            break;
+        case EventType::RESUME_BEGIN:
+            BN_LOG("{\"name\":\"resume\",\"ph\":\"B\",\"ts\":", us, ",\"pid\":0,\"tid\":", event.id, "}", comma);
+            break;
+        case EventType::RESUME_END:
+            BN_LOG("{\"name\":\"resume\",\"ph\":\"E\",\"ts\":", us, ",\"pid\":0,\"tid\":", event.id, "}", comma);
+            break;
+        case EventType::COMPLETE:
+            BN_LOG("{\"name\":\"complete\",\"ph\":\"i\",\"ts\":", us, ",\"pid\":0,\"tid\":", event.id, "}", comma);
+            break;
+        case EventType::SIGNAL:
+            BN_LOG("{\"name\":\"signal\",\"ph\":\"i\",\"ts\":", us, ",\"pid\":0,\"tid\":0,\"args\":{\"kind\":",
+                   int(event.signalKind), ",\"key\":", event.id, "}}", comma);
+            break;
+        case EventType::UPDATE_BEGIN:
+            BN_LOG("{\"name\":\"update\",\"ph\":\"B\",\"ts\":", us, ",\"pid\":0,\"tid\":0}", comma);
+            break;
+        case EventType::UPDATE_END:
+            BN_LOG("{\"name\":\"update\",\"ph\":\"E\",\"ts\":", us, ",\"pid\":0,\"tid\":0}", comma);
+            break;
+        default:
+            BN_ERROR("Invalid event type: ", int(event.type));
+        }
+    }
+
+    BN_LOG("]");
+
+    clear();
+}
+
+void TaskTrace::clear()
+{
+    _head = 0;
+    _count = 0;
+}
+
+} // namespace task
+
+#endif // TASK_TRACE_ENABLED
@@ -3,9 +3,11 @@
 
 #include "WalkingNinja.hpp"
 
-#include <bn_string.h>
+#include <bn_sprite_animate_actions.h>
 
+#include "TaskActionAwaiter.hpp"
 #include "TaskManager.hpp"
+#include "TaskWhen.hpp"
 
 namespace
 {
@@ -30,28 +32,24 @@ auto clampInitPos(bn::fixed_point pos) -> bn::fixed_point
 } // namespace
 
 WalkingNinja::WalkingNinja(int npcId, const bn::fixed_point& initPos, task::TaskManager& taskManager,
-                           bn::sprite_text_generator& textGen)
-    : _npcId(npcId), _taskManager(taskManager), _textGen(textGen), _prevDirection(Direction::NONE),
-      _prevX(clampInitPos(initPos).x()), _sprite(SPR_ITEM.create_sprite(clampInitPos(initPos), STOP_GFX_IDX))
+                           const bn::sprite_font& font)
+    : WalkingNinja(npcId, initPos, taskManager)
 {
+    // hidden until the first walk ends
+    _distanceLabel.emplace(font, _sprite.position() + TEXT_DIFF);
+    _distanceLabel->setVisible(false);
+    _distanceLabel->setBgPriority(3);
+
+    // no glyph is attached until the label has a value
+    attachLabelGlyphs();
 }
 
-void WalkingNinja::update()
+WalkingNinja::WalkingNinja(int npcId, const bn::fixed_point& initPos, task::TaskManager& taskManager)
+    : _npcId(npcId), _taskManager(taskManager), _prevDirection(Direction::NONE),
+      _prevX(clampInitPos(initPos).x()), _sprite(SPR_ITEM.create_sprite(clampInitPos(initPos), STOP_GFX_IDX)),
+      _spriteGroup(_sprite.position())
 {
-    if (_spriteAnimAction && !_spriteAnimAction->done())
-        _spriteAnimAction->update();
-
-    if (_spriteMoveAction && !_spriteMoveAction->done())
-    {
-        _spriteMoveAction->update();
-
-        if (_spriteMoveAction->done())
-            stopWalk();
-    }
-
-    for (auto& textMove : _distanceTextMoveActions)
-        if (!textMove.done())
-            textMove.update();
+    _spriteGroup.attach(_sprite);
 }
 
 void WalkingNinja::changeWalkDirection()
@@ -59,20 +57,19 @@ void WalkingNinja::changeWalkDirection()
     stopWalk();
 
     // start new ninja move task
-    auto task = walk();
-    if (!task.done())
-        _taskManager.addTask(std::move(task));
+    _taskManager.spawnTask([this] { return walk(); });
 }
 
 void WalkingNinja::stopWalk()
 {
     // end walking by sending `NPC_WALK_END` signal.
     // this resume to the ninja move task to finish it, if this ninja is moving.
-    _taskManager.onSignal(task::TaskSignal{
-        .kind = task::TaskSignal::Kind::NPC_WALK_END,
-        .argument = decltype(task::TaskSignal::argument)(_npcId),
-        .result = decltype(task::TaskSignal::result)(_sprite.x() - _prevX),
-    });
+    _taskManager.onSignal(makeWalkEndSignal());
+}
+
+bool WalkingNinja::isWalking() const
+{
+    return _isWalking;
 }
 
 auto WalkingNinja::walk() -> task::Task
@@ -85,42 +82,61 @@ auto WalkingNinja::walk() -> task::Task
     const auto& gfxIdxes = (curDirection == Direction::LEFT) ? LEFT_GFX_IDXES : RIGHT_GFX_IDXES;
     const auto& destination = (curDirection == Direction::LEFT) ? leftMostPos() : rightMostPos();
 
-    _spriteAnimAction =
-        decltype(_spriteAnimAction)::value_type::forever(_sprite, ANIM_WAIT_UPDATES, SPR_ITEM.tiles_item(), gfxIdxes);
-    _spriteMoveAction = bn::sprite_move_to_action(_sprite, MOVE_DURATION_UPDATES, destination);
+    _isWalking = true;
 
-    const bn::fixed_point diff = destination - _sprite.position();
+    // These actions are updated by `TaskManager` only while awaited.
+    // The distance label is moved along with the ninja in the sprite group.
+    task::ActionAwaiter<SpriteGroupMoveToAction<1 + NumericLabel::MAX_GLYPHS>> moveAwaiter(
+        _spriteGroup, MOVE_DURATION_UPDATES, destination);
+    task::ActionAwaiter<bn::sprite_animate_action<4>> animAwaiter(
+        bn::sprite_animate_action<4>::forever(_sprite, ANIM_WAIT_UPDATES, SPR_ITEM.tiles_item(), gfxIdxes));
 
-    BN_ASSERT(_distanceTextMoveActions.empty());
-    for (auto& text : _distanceTexts)
-        _distanceTextMoveActions.emplace_back(text, MOVE_DURATION_UPDATES, text.position() + diff);
+    // await for the ninja to arrive, or to be stopped by `NPC_WALK_END` signal.
+    // the other awaiters are cancelled then, which also stops their actions.
+    task::NpcWalkEndAwaiter stopAwaiter(_npcId);
+    co_await task::whenAny(moveAwaiter, stopAwaiter, animAwaiter);
 
-    // await for the walk to end
-    task::NpcWalkEndAwaiter walkEndAwaiter(_npcId);
-    const bn::fixed movedDistance = co_await walkEndAwaiter;
+    const bn::fixed movedDistance = _sprite.x() - _prevX;
 
     // stop moving
-    _spriteAnimAction.reset();
-    _spriteMoveAction.reset();
-    _distanceTextMoveActions.clear();
+    _isWalking = false;
     _sprite.set_tiles(SPR_ITEM.tiles_item(), STOP_GFX_IDX);
 
-    // update distance text with new moved distance
-    _distanceTexts.clear();
-
-    const auto prevAlign = _textGen.alignment();
-    _textGen.set_center_alignment();
-
-    _textGen.generate(_sprite.position() + TEXT_DIFF, bn::to_string<TEXT_SPR_CNT * 4>(movedDistance), _distanceTexts);
-    for (auto& text : _distanceTexts)
-        text.set_bg_priority(3);
+    // update distance label with new moved distance, which swaps the tiles of the changed glyphs only
+    if (_distanceLabel)
+    {
+        _distanceLabel->setValue(movedDistance);
+        _distanceLabel->setPosition(_sprite.position() + TEXT_DIFF);
+        _distanceLabel->setVisible(true);
 
-    _textGen.set_alignment(prevAlign);
+        // re-attach the glyphs, as their count & offsets from the ninja are changed.
+        // the group holds the glyph sprites too, so the ones dropped by the label are released only here.
+        attachLabelGlyphs();
+    }
 
     _prevDirection = curDirection;
     co_return;
 }
 
+void WalkingNinja::attachLabelGlyphs()
+{
+    _spriteGroup.clear();
+    _spriteGroup.attach(_sprite);
+
+    // the label only keeps the sprites of the glyphs in use
+    for (const auto& glyph : _distanceLabel->sprites())
+        _spriteGroup.attach(glyph);
+}
+
+auto WalkingNinja::makeWalkEndSignal() const -> task::TaskSignal
+{
+    return task::TaskSignal{
+        .kind = task::TaskSignal::Kind::NPC_WALK_END,
+        .key = _npcId,
+        .payload = {.npcWalkEnd = {.movedDistance = _sprite.x() - _prevX}},
+    };
+}
+
 auto WalkingNinja::leftMostPos() -> bn::fixed_point
 {
     return {LEFT_MOST_X, _sprite.y()};
@@ -1,35 +1,92 @@
 // SPDX-FileCopyrightText: Copyright 2023-2024 copyrat90
 // SPDX-License-Identifier: 0BSD
 
+#include <bn_array.h>
 #include <bn_core.h>
+#include <bn_format.h>
 #include <bn_keypad.h>
+#include <bn_log.h>
 #include <bn_sprite_text_generator.h>
+#include <bn_unique_ptr.h>
+#include <bn_vector.h>
 
+#include "Benchmarks.hpp"
+#include "NpcWalkerSystem.hpp"
+#include "TaskHeap.hpp"
 #include "TaskManager.hpp"
+#include "TaskTrace.hpp"
 #include "WalkingNinja.hpp"
 
 #include "common_info.h"
 #include "common_variable_8x16_sprite_font.h"
 
-int main()
+namespace
 {
-    bn::core::init();
 
-    bn::sprite_text_generator textGen(common::variable_8x16_sprite_font);
+constexpr bn::array<int, 3> STRESS_WALKER_COUNTS = {16, 64, 128};
+
+// 128 ninjas with their walk task frames don't fit in `TaskHeap`, nor in OAM with the texts
+constexpr int STRESS_NINJA_MAX_COUNT = 64;
+
+// probing the largest free block is not cheap, so update less often than the CPU usage
+constexpr int HEAP_TEXT_UPDATE_INTERVAL = 60;
+
+void updateCpuUsageText(bn::sprite_text_generator& textGen, int& cpuUpdateCounter, bn::fixed& maxCpuUsage,
+                        bn::ivector<bn::sprite_ptr>& cpuSprites)
+{
+    constexpr int UPDATE_INTERVAL = 30;
+
+    maxCpuUsage = bn::max(maxCpuUsage, bn::core::last_cpu_usage());
+
+    if (++cpuUpdateCounter >= UPDATE_INTERVAL)
+    {
+        cpuSprites.clear();
+        textGen.set_right_alignment();
+        textGen.generate(112, -65, bn::format<11>("{}%", (maxCpuUsage * 100).round_integer()), cpuSprites);
+        textGen.set_left_alignment();
+        maxCpuUsage = 0;
+        cpuUpdateCounter = 0;
+    }
+}
+
+void updateTaskHeapText(bn::sprite_text_generator& textGen, int& heapUpdateCounter,
+                        bn::ivector<bn::sprite_ptr>& heapSprites)
+{
+    if (++heapUpdateCounter >= HEAP_TEXT_UPDATE_INTERVAL)
+    {
+        auto& heap = task::TaskHeap::instance();
+
+        heapSprites.clear();
+        textGen.generate(-112, 52, bn::format<40>("heap {}B, peak {}B", heap.getUsedBytes(), heap.getPeakBytes()),
+                         heapSprites);
+        textGen.generate(-112, 64,
+                         bn::format<40>("free max {}/{}B", heap.getLargestFreeBlock(),
+                                        heap.getAllocator().available_bytes()),
+                         heapSprites);
+        heapUpdateCounter = 0;
+    }
+}
 
+void twoNinjasScene(bn::sprite_text_generator& textGen)
+{
     static constexpr bn::string_view infoTextLines[] = {
         "A/R: change moving direction",
         "B/L: stop moving",
+#ifdef TASK_TRACE_ENABLED
+        "DOWN: dump task trace",
+#endif
     };
 
     common::info info("C++20 Coroutine Task Demo", infoTextLines, textGen);
 
-    task::TaskManager taskManager;
+    // Frames of this scene are released at once on `SCENE_DESTROYED`
+    task::TaskArena taskArena(1024);
+    task::TaskManager taskManager(taskArena);
 
-    WalkingNinja ninja1(1, {WalkingNinja::LEFT_MOST_X, 10}, taskManager, textGen);
-    WalkingNinja ninja2(2, {WalkingNinja::LEFT_MOST_X, 40}, taskManager, textGen);
+    WalkingNinja ninja1(1, {WalkingNinja::LEFT_MOST_X, 10}, taskManager, common::variable_8x16_sprite_font);
+    WalkingNinja ninja2(2, {WalkingNinja::LEFT_MOST_X, 40}, taskManager, common::variable_8x16_sprite_font);
 
-    while (true)
+    while (!bn::keypad::start_pressed())
     {
         if (bn::keypad::a_pressed())
             ninja1.changeWalkDirection();
@@ -41,12 +98,257 @@ int main()
         if (bn::keypad::l_pressed())
             ninja2.stopWalk();
 
-        ninja1.update();
-        ninja2.update();
+        taskManager.update();
+
+#ifdef TASK_TRACE_ENABLED
+        if (bn::keypad::down_pressed())
+            task::TaskTrace::instance().dump();
+#endif
+
+        info.update();
+        bn::core::update();
+    }
+
+    taskManager.onSignal(task::TaskSignal{.kind = task::TaskSignal::Kind::SCENE_DESTROYED});
+}
+
+void walkerStressScene(bn::sprite_text_generator& textGen)
+{
+    static constexpr bn::string_view infoTextLines[] = {
+        "A: change walker count",
+        "R: WalkingNinja / NpcWalkerSystem",
+        "B: stop every walker each frame",
+        "L: show/hide task heap usage",
+        "SELECT: keyed / linear signal scan",
+    };
+
+    common::info info("Walker Stress Test", infoTextLines, textGen);
+
+    int cpuUpdateCounter = 0;
+    bn::fixed maxCpuUsage = 0;
+    bn::vector<bn::sprite_ptr, 4> cpuSprites;
+
+    bool showHeapUsage = false;
+    int heapUpdateCounter = 0;
+    bn::vector<bn::sprite_ptr, 12> heapSprites;
+
+    bn::vector<bn::sprite_ptr, 8> modeSprites;
+
+    task::TaskManager taskManager;
+
+    using NinjaVector = bn::vector<WalkingNinja, STRESS_NINJA_MAX_COUNT>;
+    bn::unique_ptr<NinjaVector> ninjas;
+    bn::unique_ptr<NpcWalkerSystem> walkerSystem;
+
+    int walkerCountIndex = 0;
+    bool useWalkerSystem = true;
+
+    auto updateModeText = [&]() {
+        modeSprites.clear();
+        textGen.generate(-112, 40,
+                         bn::format<32>("{} x{}, {}", useWalkerSystem ? "system" : "class",
+                                        STRESS_WALKER_COUNTS[walkerCountIndex],
+                                        taskManager.isLinearSignalScanEnabled() ? "scan" : "keyed"),
+                         modeSprites);
+        maxCpuUsage = 0;
+    };
+
+    auto respawn = [&]() {
+        // the walker system cancels its own task group, but the tasks of ninjas are cancelled first
+        if (ninjas)
+        {
+            taskManager.onSignal(task::TaskSignal{.kind = task::TaskSignal::Kind::SCENE_DESTROYED});
+            ninjas.reset();
+        }
+        walkerSystem.reset();
+
+        const int walkerCount = STRESS_WALKER_COUNTS[walkerCountIndex];
+
+        if (useWalkerSystem)
+            walkerSystem.reset(new NpcWalkerSystem(taskManager));
+        else
+            ninjas.reset(new NinjaVector());
+
+        for (int i = 0; i < walkerCount; ++i)
+        {
+            const bn::fixed x = WalkingNinja::LEFT_MOST_X + (i * 37) % 160;
+            const bn::fixed y = -64 + i * 128 / walkerCount;
+
+            if (useWalkerSystem)
+                walkerSystem->addWalker(bn::fixed_point(x, y));
+            else
+                ninjas->emplace_back(i, bn::fixed_point(x, y), taskManager);
+        }
+
+        updateModeText();
+    };
+
+    respawn();
+
+    while (!bn::keypad::start_pressed())
+    {
+        if (bn::keypad::a_pressed() || bn::keypad::r_pressed())
+        {
+            if (bn::keypad::a_pressed())
+                walkerCountIndex = (walkerCountIndex + 1) % STRESS_WALKER_COUNTS.size();
+            else
+                useWalkerSystem = !useWalkerSystem;
+
+            // `WalkingNinja` can't afford every count, see `STRESS_NINJA_MAX_COUNT`
+            if (!useWalkerSystem && STRESS_WALKER_COUNTS[walkerCountIndex] > STRESS_NINJA_MAX_COUNT)
+                walkerCountIndex = 0;
+
+            respawn();
+        }
+
+        // every walker stopped by B sends a signal, which scans every signal awaiter without the keyed wait queues
+        if (bn::keypad::select_pressed())
+        {
+            taskManager.setLinearSignalScanEnabled(!taskManager.isLinearSignalScanEnabled());
+            updateModeText();
+        }
+
+        if (bn::keypad::l_pressed())
+        {
+            showHeapUsage = !showHeapUsage;
+            heapSprites.clear();
+
+            // show on the next update, and log the frame size histogram at the same time
+            if (showHeapUsage)
+            {
+                heapUpdateCounter = HEAP_TEXT_UPDATE_INTERVAL;
+                task::TaskHeap::instance().logStats();
+            }
+        }
+
+        if (walkerSystem)
+        {
+            // decision tasks are resumed by `NPC_WALK_END` signal, and rest before walking again
+            if (bn::keypad::b_held())
+            {
+                for (int i = 0; i < walkerSystem->size(); ++i)
+                    walkerSystem->stopWalker(i);
+            }
+
+            walkerSystem->update();
+        }
+        else
+        {
+            // every ninja sends `NPC_WALK_END` signal, which resumes only the task of its own NPC id
+            if (bn::keypad::b_held())
+            {
+                for (auto& ninja : *ninjas)
+                    ninja.stopWalk();
+            }
+
+            for (auto& ninja : *ninjas)
+            {
+                if (!ninja.isWalking())
+                    ninja.changeWalkDirection();
+            }
+        }
 
         taskManager.update();
 
         info.update();
+        updateCpuUsageText(textGen, cpuUpdateCounter, maxCpuUsage, cpuSprites);
+        if (showHeapUsage)
+            updateTaskHeapText(textGen, heapUpdateCounter, heapSprites);
+        bn::core::update();
+    }
+
+    taskManager.onSignal(task::TaskSignal{.kind = task::TaskSignal::Kind::SCENE_DESTROYED});
+}
+
+void benchmarkScene(bn::sprite_text_generator& textGen)
+{
+    static constexpr bn::string_view infoTextLines[] = {
+        "A: run again",
+    };
+
+    common::info info("Task Benchmarks", infoTextLines, textGen);
+
+    bn::vector<bn::sprite_ptr, 80> resultSprites;
+
+    auto runBenchmarks = [&textGen, &resultSprites]() {
+        resultSprites.clear();
+
+        const bench::HeapChurnResult results[] = {bench::runHeapChurn(false), bench::runHeapChurn(true)};
+        const bn::string_view names[] = {"best-fit", "slab"};
+
+        for (int i = 0; i < 2; ++i)
+        {
+            const auto& result = results[i];
+            const int y = -40 + i * 28;
+
+            const auto cost = bn::format<40>("{}: {} ticks/100 ops", names[i],
+                                             result.elapsedTicks * 100 / result.allocCount);
+            const auto frag = bn::format<40>("fail {}, free {}/{}B", result.failedAllocCount,
+                                             result.largestFreeBlock, result.availableBytes);
+
+            textGen.generate(-112, y, cost, resultSprites);
+            textGen.generate(-112, y + 12, frag, resultSprites);
+
+            BN_LOG(cost, ", ", frag);
+        }
+
+        const bench::SchedulerResult scheduler = bench::runScheduler();
+
+        const auto spawn = bn::format<40>("{} tasks: {} ticks, {}B", scheduler.taskCount, scheduler.spawnTicks,
+                                          scheduler.peakHeapBytes);
+        const auto resumes = bn::format<40>("{} resumes: {}/s", scheduler.resumeCount,
+                                            int(scheduler.getResumesPerSecond()));
+
+        const auto allocFree = bn::format<40>("alloc/free: {}/{} ticks/100",
+                                              scheduler.allocTicks * 100 / scheduler.allocCount,
+                                              scheduler.freeTicks * 100 / scheduler.allocCount);
+
+        textGen.generate(-112, 16, spawn, resultSprites);
+        textGen.generate(-112, 28, resumes, resultSprites);
+        textGen.generate(-112, 56, allocFree, resultSprites);
+
+        BN_LOG(spawn, ", ", resumes, " in ", scheduler.updateCount, " updates (", scheduler.updateTicks, " ticks)");
+        BN_LOG(allocFree);
+
+        const bench::GeneratorResult generator = bench::runGenerator();
+
+        const auto pattern = bn::format<40>("{} values: gen {}, fsm {} ticks", generator.valueCount,
+                                            generator.generatorTicks, generator.stateMachineTicks);
+
+        textGen.generate(-112, 44, pattern, resultSprites);
+
+        BN_LOG(pattern);
+    };
+
+    runBenchmarks();
+
+    while (!bn::keypad::start_pressed())
+    {
+        if (bn::keypad::a_pressed())
+            runBenchmarks();
+
+        info.update();
+        bn::core::update();
+    }
+}
+
+} // namespace
+
+int main()
+{
+    bn::core::init();
+
+    bn::sprite_text_generator textGen(common::variable_8x16_sprite_font);
+
+    while (true)
+    {
+        twoNinjasScene(textGen);
+        bn::core::update();
+
+        walkerStressScene(textGen);
+        bn::core::update();
+
+        benchmarkScene(textGen);
         bn::core::update();
     }
 }